@@ -0,0 +1,99 @@
+/**
+ * @file
+ * Implementing Call_Resolver.hpp
+ */
+#include "Call_Resolver.hpp"
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/Instructions.h>
+namespace hydrogen_framework {
+Call_Resolver::Call_Resolver(llvm::Module *mod, bool pointsTo) : resolverPointsTo(pointsTo) {
+  for (llvm::Function &F : *mod) {
+    resolverFunctions.push_back(&F);
+    if (F.hasAddressTaken()) {
+      resolverSignatures[F.getFunctionType()].push_back(&F);
+    } // End check for address taken
+  }   // End loop for functions
+} // End Call_Resolver constructor
+
+std::vector<const llvm::Function *> Call_Resolver::resolveCallTargets(llvm::CallSite callSite) {
+  std::vector<const llvm::Function *> callTargets;
+  if (resolverPointsTo) {
+    std::set<const llvm::Function *> targets;
+    std::set<const llvm::Value *> visited;
+    if (collectPointsTo(callSite.getCalledValue(), targets, visited) && !targets.empty()) {
+      for (auto F : resolverFunctions) {
+        if (targets.find(F) != targets.end()) {
+          callTargets.push_back(F);
+        } // End check for target
+      }   // End loop for resolverFunctions
+      return callTargets;
+    } // End check for points-to result
+  }   // End check for resolverPointsTo
+  auto findSignature = resolverSignatures.find(callSite.getFunctionType());
+  if (findSignature != resolverSignatures.end()) {
+    callTargets = findSignature->second;
+  } // End check for findSignature
+  return callTargets;
+} // End resolveCallTargets
+
+bool Call_Resolver::collectPointsTo(const llvm::Value *V, std::set<const llvm::Function *> &targets,
+                                    std::set<const llvm::Value *> &visited) {
+  V = V->stripPointerCasts();
+  if (!visited.insert(V).second) {
+    return true;
+  } // End check for visited value
+  if (auto F = llvm::dyn_cast<llvm::Function>(V)) {
+    targets.insert(F);
+    return true;
+  } // End check for Function
+  if (llvm::isa<llvm::ConstantPointerNull>(V)) {
+    return true;
+  } // End check for null
+  if (auto LI = llvm::dyn_cast<llvm::LoadInst>(V)) {
+    return collectStoredTargets(LI->getPointerOperand()->stripPointerCasts(), targets, visited);
+  } // End check for LoadInst
+  if (auto PN = llvm::dyn_cast<llvm::PHINode>(V)) {
+    for (auto &incoming : PN->incoming_values()) {
+      if (!collectPointsTo(incoming, targets, visited)) {
+        return false;
+      } // End check for incoming
+    }   // End loop for incoming values
+    return true;
+  } // End check for PHINode
+  if (auto SI = llvm::dyn_cast<llvm::SelectInst>(V)) {
+    return collectPointsTo(SI->getTrueValue(), targets, visited) &&
+           collectPointsTo(SI->getFalseValue(), targets, visited);
+  } // End check for SelectInst
+  return false;
+} // End collectPointsTo
+
+bool Call_Resolver::collectStoredTargets(const llvm::Value *ptr, std::set<const llvm::Function *> &targets,
+                                         std::set<const llvm::Value *> &visited) {
+  if (!visited.insert(ptr).second) {
+    return true;
+  } // End check for visited ptr
+  if (auto GV = llvm::dyn_cast<llvm::GlobalVariable>(ptr)) {
+    /* Without a definitive initializer the global can be changed outside the module */
+    if (!GV->hasDefinitiveInitializer() || !collectPointsTo(GV->getInitializer(), targets, visited)) {
+      return false;
+    } // End check for initializer
+  } else if (!llvm::isa<llvm::AllocaInst>(ptr)) {
+    return false;
+  } // End check for ptr kind
+  for (auto U : ptr->users()) {
+    if (auto LI = llvm::dyn_cast<llvm::LoadInst>(U)) {
+      if (LI->getPointerOperand() != ptr) {
+        return false;
+      } // End check for load through ptr
+    } else if (auto SI = llvm::dyn_cast<llvm::StoreInst>(U)) {
+      if (SI->getPointerOperand() != ptr || !collectPointsTo(SI->getValueOperand(), targets, visited)) {
+        return false;
+      } // End check for store into ptr
+    } else {
+      /* Any other use can write through an alias of ptr */
+      return false;
+    } // End check for user kind
+  }   // End loop for users
+  return true;
+} // End collectStoredTargets
+} // namespace hydrogen_framework
@@ -0,0 +1,60 @@
+/**
+ * @file
+ * Call_Resolver Class: Narrowing the targets of indirect calls
+ */
+#ifndef CALL_RESOLVER_H
+#define CALL_RESOLVER_H
+
+#include <llvm/IR/CallSite.h>
+#include <llvm/IR/Module.h>
+#include <map>
+#include <set>
+#include <vector>
+namespace hydrogen_framework {
+/**
+ * Call_Resolver Class: Finds the functions an indirect call can reach within a module
+ * Targets are narrowed to address-taken functions of the call signature. The optional points-to pass follows the
+ * called pointer through casts, phi and select, and through loads of globals and allocas whose stored values are all
+ * known functions. The module is treated as the whole program.
+ * All queries are read-only, so a single Call_Resolver can be shared by concurrent workers
+ */
+class Call_Resolver {
+public:
+  /**
+   * Constructor
+   */
+  Call_Resolver(llvm::Module *mod, bool pointsTo);
+
+  /**
+   * Destructor
+   */
+  ~Call_Resolver() { resolverSignatures.clear(); }
+
+  /**
+   * Return the possible targets of an indirect call. Empty if nothing is known about the target
+   * Targets are returned in module order
+   */
+  std::vector<const llvm::Function *> resolveCallTargets(llvm::CallSite callSite);
+
+private:
+  /**
+   * Collect the functions V can point to into targets
+   * Returns false if some value reaching V is not understood
+   */
+  bool collectPointsTo(const llvm::Value *V, std::set<const llvm::Function *> &targets,
+                       std::set<const llvm::Value *> &visited);
+
+  /**
+   * Collect the functions stored into the global or alloca ptr, including the global initializer
+   * Returns false if ptr escapes or something other than a function is stored into it
+   */
+  bool collectStoredTargets(const llvm::Value *ptr, std::set<const llvm::Function *> &targets,
+                            std::set<const llvm::Value *> &visited);
+
+  bool resolverPointsTo;                                 /**< Run the points-to pass */
+  std::vector<const llvm::Function *> resolverFunctions; /**< Functions of the module in module order */
+  /** Address-taken functions of the module grouped by signature */
+  std::map<llvm::FunctionType *, std::vector<const llvm::Function *>> resolverSignatures;
+};                                                       // End Call_Resolver Class
+} // namespace hydrogen_framework
+#endif
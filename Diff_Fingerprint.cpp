@@ -0,0 +1,293 @@
+/**
+ * @file
+ * Implementing Diff_Fingerprint.hpp
+ */
+#include "Diff_Fingerprint.hpp"
+#include "Graph.hpp"
+#include "Module.hpp"
+#include <algorithm>
+#include <boost/filesystem.hpp>
+#include <llvm/IR/Constants.h>
+#include <limits>
+namespace hydrogen_framework {
+/**
+ * Fold value into hash
+ */
+static uint64_t combineHash(uint64_t hash, uint64_t value) {
+  return hash ^ (value + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2));
+} // End combineHash
+
+/**
+ * Return the hash of a name
+ */
+static uint64_t hashName(llvm::StringRef name) {
+  return Diff_Util::hashLine(Diff_Line(name.data(), name.size()));
+} // End hashName
+
+/**
+ * Mark the lines of the instructions of block in lines, ignoring lines past the end of the file
+ */
+static void markBlockLines(const Fingerprint_Block &block, std::vector<unsigned> &lines) {
+  for (auto line : block.instructionLines) {
+    if (line < lines.size()) {
+      lines[line] = 1;
+    } // End check for line in file
+  }   // End loop for instructionLines
+} // End markBlockLines
+
+/**
+ * Record that the lines of two blocks with the same hash correspond, instruction by instruction
+ * A line corresponding to more than one line gets the partner noPartner
+ */
+static void pairBlockLines(const Fingerprint_Block &before, const Fingerprint_Block &after,
+                           std::vector<unsigned> &beforePartner, std::vector<unsigned> &afterPartner) {
+  static const unsigned noPartner = std::numeric_limits<unsigned>::max();
+  for (std::size_t index = 0; index < before.instructionLines.size() && index < after.instructionLines.size();
+       ++index) {
+    unsigned beforeLine = before.instructionLines[index];
+    unsigned afterLine = after.instructionLines[index];
+    if (beforeLine == 0 || afterLine == 0 || beforeLine >= beforePartner.size() || afterLine >= afterPartner.size()) {
+      continue;
+    } // End check for line in file
+    if (beforePartner[beforeLine] != afterLine) {
+      beforePartner[beforeLine] = beforePartner[beforeLine] ? noPartner : afterLine;
+    } // End check for new partner
+    if (afterPartner[afterLine] != beforeLine) {
+      afterPartner[afterLine] = afterPartner[afterLine] ? noPartner : beforeLine;
+    } // End check for new partner
+  }   // End loop for instructions
+} // End pairBlockLines
+
+/**
+ * Turn the marks of lines into running counts, so that a stretch of lines holds a mark when its counts differ
+ */
+static void countMarkedLines(std::vector<unsigned> &lines) {
+  for (std::size_t index = 1; index < lines.size(); ++index) {
+    lines[index] += lines[index - 1];
+  } // End loop for lines
+} // End countMarkedLines
+
+uint64_t Diff_Fingerprint::hashInstruction(llvm::Instruction &I) {
+  uint64_t hash = combineHash(I.getOpcode(), I.getNumOperands());
+  hash = combineHash(hash, I.getType()->getTypeID());
+  if (llvm::CmpInst *cmp = llvm::dyn_cast<llvm::CmpInst>(&I)) {
+    hash = combineHash(hash, cmp->getPredicate());
+  } // End check for CmpInst
+  llvm::CallSite call(&I);
+  if (call) {
+    llvm::Function *callee = call.getCalledFunction();
+    hash = combineHash(hash, callee ? hashName(callee->getName()) : 0);
+  } // End check for CallSite
+  /* Constants and globals are the same in both versions, instructions and arguments are not */
+  for (llvm::Value *operand : I.operand_values()) {
+    if (llvm::ConstantInt *constant = llvm::dyn_cast<llvm::ConstantInt>(operand)) {
+      hash = combineHash(hash, constant->getValue().getLimitedValue());
+    } else if (llvm::GlobalValue *global = llvm::dyn_cast<llvm::GlobalValue>(operand)) {
+      hash = combineHash(hash, hashName(global->getName()));
+    } // End check for operand
+  }   // End loop for operands
+  return hash;
+} // End hashInstruction
+
+uint64_t Diff_Fingerprint::hashBlock(llvm::BasicBlock &BB) {
+  uint64_t hash = 0;
+  for (llvm::Instruction &I : BB) {
+    hash = combineHash(hash, hashInstruction(I));
+  } // End loop for BasicBlock
+  const llvm::Instruction *terminator = BB.getTerminator();
+  return combineHash(hash, terminator ? terminator->getNumSuccessors() : 0);
+} // End hashBlock
+
+uint64_t Diff_Fingerprint::hashFunction(llvm::Function &F, const std::vector<uint64_t> &blockHashes) {
+  uint64_t hash = combineHash(F.arg_size(), F.isVarArg());
+  std::map<const llvm::BasicBlock *, std::size_t> blockIndex;
+  for (llvm::BasicBlock &BB : F) {
+    blockIndex.insert(std::make_pair(&BB, blockIndex.size()));
+  } // End loop for Function
+  std::size_t index = 0;
+  for (llvm::BasicBlock &BB : F) {
+    hash = combineHash(hash, blockHashes[index++]);
+    /* CFG shape: the position of every successor */
+    const llvm::Instruction *terminator = BB.getTerminator();
+    for (unsigned successor = 0; terminator && successor < terminator->getNumSuccessors(); ++successor) {
+      hash = combineHash(hash, blockIndex[terminator->getSuccessor(successor)]);
+    } // End loop for successors
+  }   // End loop for Function
+  return hash;
+} // End hashFunction
+
+void Diff_Fingerprint::fingerprintModule(Module *mod) {
+  for (llvm::Function &F : *mod->getPtr()) {
+    if (mod->isFunctionSkipped(F) || !mod->materializeFunction(F) || F.empty()) {
+      continue;
+    } // End check for available function
+    Fingerprint_Function func;
+    func.functionName = F.hasName() ? F.getName().str() : "Unknown_Function";
+    std::string functionFile;
+    std::vector<uint64_t> blockHashes;
+    /* Instructions without a line stay on the line before them, as in buildFunctionICFG */
+    unsigned currentLine = 0;
+    for (llvm::BasicBlock &BB : F) {
+      Fingerprint_Block block;
+      block.blockHash = hashBlock(BB);
+      blockHashes.push_back(block.blockHash);
+      /* One location per instruction of the block */
+      for (llvm::DILocation *DILoc : getBlockLocationTable(BB)) {
+        if (DILoc && DILoc->getLine() != 0) {
+          currentLine = DILoc->getLine();
+        } // End check for DILoc
+        if (functionFile.empty()) {
+          functionFile = DILoc ? DILoc->getFilename().str() : "Unknown_File";
+        } // End check for functionFile
+        block.instructionLines.push_back(currentLine);
+      } // End loop for blockLocations
+      func.blocks.push_back(block);
+    } // End loop for Function
+    func.functionHash = hashFunction(F, blockHashes);
+    fileFunctions[boost::filesystem::path(functionFile).filename().string()].push_back(func);
+  } // End loop for Module
+} // End fingerprintModule
+
+const std::vector<Fingerprint_Function> &Diff_Fingerprint::getFileFunctions(std::string fileName) const {
+  static const std::vector<Fingerprint_Function> noFunctions;
+  auto findFile = fileFunctions.find(fileName);
+  return findFile != fileFunctions.end() ? findFile->second : noFunctions;
+} // End getFileFunctions
+
+Diff_Vars::editScript Diff_Fingerprint::matchFile(const Diff_Fingerprint &next, std::string fileName,
+                                                  const std::vector<Diff_Line> &before,
+                                                  const std::vector<Diff_Line> &after) const {
+  std::map<std::string, const Fingerprint_Function *> afterFunctions;
+  for (auto &func : next.getFileFunctions(fileName)) {
+    afterFunctions.insert(std::make_pair(func.functionName, &func));
+  } // End loop for next functions
+  /* Lines of unmatched blocks on either side, and the corresponding lines of matched ones. Line 0 is unused */
+  std::vector<unsigned> beforeChanged(before.size() + 1, 0), afterChanged(after.size() + 1, 0);
+  std::vector<unsigned> beforePartner(before.size() + 1, 0), afterPartner(after.size() + 1, 0);
+  for (auto &func : getFileFunctions(fileName)) {
+    auto findFunc = afterFunctions.find(func.functionName);
+    if (findFunc == afterFunctions.end()) {
+      for (auto &block : func.blocks) {
+        markBlockLines(block, beforeChanged);
+      } // End loop for deleted blocks
+      continue;
+    } // End check for deleted function
+    const Fingerprint_Function &nextFunc = *findFunc->second;
+    afterFunctions.erase(findFunc);
+    if (func.functionHash == nextFunc.functionHash && func.blocks.size() == nextFunc.blocks.size()) {
+      for (std::size_t index = 0; index < func.blocks.size(); ++index) {
+        pairBlockLines(func.blocks[index], nextFunc.blocks[index], beforePartner, afterPartner);
+      } // End loop for blocks
+      continue;
+    } // End check for unchanged function
+    /* Match blocks by hash, keeping their order */
+    std::map<uint64_t, std::vector<std::size_t>> nextBlocks;
+    for (std::size_t index = 0; index < nextFunc.blocks.size(); ++index) {
+      nextBlocks[nextFunc.blocks[index].blockHash].push_back(index);
+    } // End loop for next blocks
+    std::vector<bool> nextMatched(nextFunc.blocks.size(), false);
+    std::size_t nextFirst = 0;
+    for (auto &block : func.blocks) {
+      auto findBlock = nextBlocks.find(block.blockHash);
+      if (findBlock != nextBlocks.end()) {
+        auto findIndex = std::lower_bound(findBlock->second.begin(), findBlock->second.end(), nextFirst);
+        if (findIndex != findBlock->second.end()) {
+          pairBlockLines(block, nextFunc.blocks[*findIndex], beforePartner, afterPartner);
+          nextMatched[*findIndex] = true;
+          nextFirst = *findIndex + 1;
+          continue;
+        } // End check for findIndex
+      }   // End check for findBlock
+      markBlockLines(block, beforeChanged);
+    } // End loop for blocks
+    for (std::size_t index = 0; index < nextFunc.blocks.size(); ++index) {
+      if (!nextMatched[index]) {
+        markBlockLines(nextFunc.blocks[index], afterChanged);
+      } // End check for nextMatched
+    }   // End loop for next blocks
+  }     // End loop for functions
+  for (auto &func : afterFunctions) {
+    for (auto &block : func.second->blocks) {
+      markBlockLines(block, afterChanged);
+    } // End loop for added blocks
+  }   // End loop for added functions
+  /* A line is an anchor when it corresponds to exactly one line and neither is changed */
+  std::vector<std::pair<std::size_t, std::size_t>> candidates;
+  for (std::size_t beforeLine = 1; beforeLine < beforePartner.size(); ++beforeLine) {
+    unsigned afterLine = beforePartner[beforeLine];
+    if (afterLine == 0) {
+      continue;
+    } // End check for partner
+    if (afterLine >= afterPartner.size() || afterPartner[afterLine] != beforeLine) {
+      /* Lines split or joined between versions are left to the text diff */
+      beforeChanged[beforeLine] = 1;
+      if (afterLine < afterPartner.size()) {
+        afterChanged[afterLine] = 1;
+      } // End check for afterLine
+    } else if (!beforeChanged[beforeLine] && !afterChanged[afterLine]) {
+      candidates.push_back(std::make_pair(beforeLine - 1, afterLine - 1));
+    } // End check for single partner
+  }   // End loop for beforePartner
+  for (std::size_t afterLine = 1; afterLine < afterPartner.size(); ++afterLine) {
+    if (afterPartner[afterLine] == std::numeric_limits<unsigned>::max()) {
+      afterChanged[afterLine] = 1;
+    } // End check for many partners
+  }   // End loop for afterPartner
+  countMarkedLines(beforeChanged);
+  countMarkedLines(afterChanged);
+  /* Longest run of candidates increasing on the after side, by patience sorting */
+  std::vector<std::size_t> tails;
+  std::vector<long long> previous(candidates.size(), -1);
+  for (std::size_t index = 0; index < candidates.size(); ++index) {
+    auto pile = std::lower_bound(tails.begin(), tails.end(), candidates[index].second,
+                                 [&](std::size_t tail, std::size_t value) { return candidates[tail].second < value; });
+    if (pile != tails.begin()) {
+      previous[index] = static_cast<long long>(*(pile - 1));
+    } // End check for first pile
+    if (pile == tails.end()) {
+      tails.push_back(index);
+    } else {
+      *pile = index;
+    } // End check for new pile
+  }   // End loop for candidates
+  std::vector<std::pair<std::size_t, std::size_t>> anchors;
+  for (long long index = tails.empty() ? -1 : static_cast<long long>(tails.back()); index != -1;
+       index = previous[(size_t)index]) {
+    anchors.push_back(candidates[(size_t)index]);
+  } // End loop for anchors
+  std::reverse(anchors.begin(), anchors.end());
+  anchors.push_back(std::make_pair(before.size(), after.size()));
+  /* Stitch the regions between anchors, with line numbers starting at 1 */
+  Diff_Vars::editScript script;
+  std::size_t beforeFirst = 0;
+  std::size_t afterFirst = 0;
+  for (std::size_t region = 0; region < anchors.size(); ++region) {
+    std::size_t beforeLast = anchors[region].first;
+    std::size_t afterLast = anchors[region].second;
+    long long beforeCount = static_cast<long long>(beforeLast - beforeFirst);
+    long long afterCount = static_cast<long long>(afterLast - afterFirst);
+    if (!afterCount || !beforeCount) {
+      Diff_Vars::appendEdit(script, Diff_Vars::SES_DELETE, beforeFirst + 1, 0, beforeCount);
+      Diff_Vars::appendEdit(script, Diff_Vars::SES_ADD, 0, afterFirst + 1, afterCount);
+    } else if (beforeCount == afterCount && beforeChanged[beforeLast] == beforeChanged[beforeFirst] &&
+               afterChanged[afterLast] == afterChanged[afterFirst]) {
+      /* No code changed in between, so the lines correspond by position whatever their text */
+      Diff_Vars::appendEdit(script, Diff_Vars::SES_COMMON, beforeFirst + 1, afterFirst + 1, beforeCount);
+    } else {
+      Diff_Util regionDiff(before.data() + beforeFirst, beforeCount, after.data() + afterFirst, afterCount);
+      regionDiff.setDiffMode(Diff_Util::DIFF_HASHED);
+      regionDiff.compose();
+      for (auto &edit : regionDiff.getEditScript()) {
+        Diff_Vars::appendEdit(script, edit.type, edit.beforeIdx ? edit.beforeIdx + beforeFirst : 0,
+                              edit.afterIdx ? edit.afterIdx + afterFirst : 0, edit.count);
+      } // End loop for region edits
+    }   // End check for region sides
+    if (region + 1 < anchors.size()) {
+      Diff_Vars::appendEdit(script, Diff_Vars::SES_COMMON, beforeLast + 1, afterLast + 1, 1);
+    } // End check for anchor after region
+    beforeFirst = beforeLast + 1;
+    afterFirst = afterLast + 1;
+  } // End loop for regions
+  return script;
+} // End matchFile
+} // namespace hydrogen_framework
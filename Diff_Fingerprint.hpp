@@ -0,0 +1,84 @@
+/**
+ * @file
+ * Diff_Fingerprint Class: Structural hashes of the functions and basic blocks of a Module
+ */
+#ifndef DIFF_FINGERPRINT_H
+#define DIFF_FINGERPRINT_H
+
+#include "Diff_Util.hpp"
+#include <cstdint>
+#include <llvm/IR/Function.h>
+#include <map>
+#include <string>
+#include <vector>
+namespace hydrogen_framework {
+/* Forward declaration */
+class Module;
+
+/**
+ * Fingerprint_Block: Structural hash of a basic block and the source lines of its instructions
+ */
+struct Fingerprint_Block {
+  uint64_t blockHash;                     /**< Hash of the opcodes, operands, callees and successor count */
+  std::vector<unsigned> instructionLines; /**< Source line of each instruction, as the ICFG attributes it */
+};
+
+/**
+ * Fingerprint_Function: Structural hash of a function and its blocks in order
+ */
+struct Fingerprint_Function {
+  std::string functionName;              /**< Name of the function, as the ICFG names it */
+  uint64_t functionHash;                 /**< Hash of the block hashes and the CFG shape */
+  std::vector<Fingerprint_Block> blocks; /**< Blocks in function order */
+};
+
+/**
+ * Diff_Fingerprint Class: Matches two versions of a source file through the IR built from them
+ * Code lines of functions and blocks with the same hash in both versions are matched without looking at their text.
+ * Only the lines around changed blocks are diffed as text
+ */
+class Diff_Fingerprint {
+public:
+  /**
+   * Constructor
+   */
+  Diff_Fingerprint() {}
+
+  /**
+   * Fingerprint every function of mod the ICFG is built for
+   * Not thread safe, since function bodies may be materialized
+   */
+  void fingerprintModule(Module *mod);
+
+  /**
+   * Return the edit script from before, the lines of fileName in this version, to after, its lines in next
+   * Lines of unchanged blocks anchor the script, changed stretches between anchors are diffed as text
+   */
+  Diff_Vars::editScript matchFile(const Diff_Fingerprint &next, std::string fileName,
+                                  const std::vector<Diff_Line> &before, const std::vector<Diff_Line> &after) const;
+
+  /**
+   * Return the hash of an instruction. Local values are left out so that it is stable across versions
+   */
+  static uint64_t hashInstruction(llvm::Instruction &I);
+
+  /**
+   * Return the hash of a basic block
+   */
+  static uint64_t hashBlock(llvm::BasicBlock &BB);
+
+  /**
+   * Return the hash of a function from its block hashes and the successors of each block
+   */
+  static uint64_t hashFunction(llvm::Function &F, const std::vector<uint64_t> &blockHashes);
+
+private:
+  /**
+   * Return the functions of fileName. Empty if the file has none
+   */
+  const std::vector<Fingerprint_Function> &getFileFunctions(std::string fileName) const;
+
+  std::map<std::string, std::vector<Fingerprint_Function>> fileFunctions; /**< Functions by file name */
+};                                                                        // End Diff_Fingerprint Class
+} // namespace hydrogen_framework
+#endif
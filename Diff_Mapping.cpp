@@ -5,8 +5,15 @@
  */
 #include "Diff_Mapping.hpp"
 namespace hydrogen_framework {
-void Diff_Mapping::putMapping(std::vector<sesElem> seqVector) {
-  for (auto iter : seqVector) {
+const long long Diff_Mapping::noLine;
+
+void Diff_Mapping::putMapping(const std::vector<sesElem> &seqVector) {
+  std::size_t counts[3] = {0, 0, 0};
+  for (auto &iter : seqVector) {
+    ++counts[iter.second.type + 1];
+  } // End loop for counts
+  reserveMapping(counts[SES_ADD + 1], counts[SES_DELETE + 1], counts[SES_COMMON + 1]);
+  for (auto &iter : seqVector) {
     elemInfo info;
     switch (iter.second.type) {
     case SES_ADD:
@@ -25,13 +32,50 @@ void Diff_Mapping::putMapping(std::vector<sesElem> seqVector) {
       info.beforeIdx = iter.second.beforeIdx;
       info.afterIdx = iter.second.afterIdx;
       info.type = SES_COMMON;
-      matchedLines.insert(std::pair<long long, long long>(iter.second.beforeIdx, iter.second.afterIdx));
+      matchedLines.push_back(std::make_pair(iter.second.beforeIdx, iter.second.afterIdx));
       break;
     }
     lineMap.push_back(info);
   } // End loop for seqVector
+  indexMapping();
+} // End putMapping
+
+void Diff_Mapping::putMapping(const editScript &script) {
+  std::size_t counts[3] = {0, 0, 0};
+  for (auto &edit : script) {
+    counts[edit.type + 1] += static_cast<std::size_t>(edit.count);
+  } // End loop for counts
+  reserveMapping(counts[SES_ADD + 1], counts[SES_DELETE + 1], counts[SES_COMMON + 1]);
+  for (auto &edit : script) {
+    for (long long index = 0; index < edit.count; ++index) {
+      elemInfo info;
+      info.beforeIdx = edit.beforeIdx ? edit.beforeIdx + index : 0;
+      info.afterIdx = edit.afterIdx ? edit.afterIdx + index : 0;
+      info.type = edit.type;
+      switch (edit.type) {
+      case SES_ADD:
+        addedLines.push_back(info.afterIdx);
+        break;
+      case SES_DELETE:
+        deletedLines.push_back(info.beforeIdx);
+        break;
+      case SES_COMMON:
+        matchedLines.push_back(std::make_pair(info.beforeIdx, info.afterIdx));
+        break;
+      } // End switch for edit.type
+      lineMap.push_back(info);
+    } // End loop for edit
+  }   // End loop for script
+  indexMapping();
 } // End putMapping
 
+void Diff_Mapping::reserveMapping(std::size_t added, std::size_t deleted, std::size_t matched) {
+  lineMap.reserve(lineMap.size() + added + deleted + matched);
+  addedLines.reserve(addedLines.size() + added);
+  deletedLines.reserve(deletedLines.size() + deleted);
+  matchedLines.reserve(matchedLines.size() + matched);
+} // End reserveMapping
+
 void Diff_Mapping::printMapping() {
   std::cout << "File name : " << fileName << "\n";
   for (auto iter : lineMap) {
@@ -76,21 +120,30 @@ void Diff_Mapping::printFileInfo() {
   std::cout << "----\n";
 } // End printFileInfo
 
-long long Diff_Mapping::getAfterLineNumber(long long currLine) {
-  for (auto iter : lineMap) {
-    if (iter.beforeIdx == currLine) {
-      return iter.afterIdx;
-    } // End check for currLine
-  }   // End loop for lineMap
-  return std::numeric_limits<unsigned>::max();
-} // End getNewLineNumber
-
-long long Diff_Mapping::getBeforeLineNumber(long long currLine) {
-  for (auto iter : lineMap) {
-    if (iter.afterIdx == currLine) {
-      return iter.beforeIdx;
-    } // End check for currLine
+void Diff_Mapping::indexMapping() {
+  long long lastBefore = 0;
+  long long lastAfter = 0;
+  for (auto &iter : lineMap) {
+    lastBefore = std::max(lastBefore, iter.beforeIdx);
+    lastAfter = std::max(lastAfter, iter.afterIdx);
+  } // End loop for lineMap
+  beforeToAfter.assign(lastBefore + 1, noLine);
+  afterToBefore.assign(lastAfter + 1, noLine);
+  addedLineSet.assign(lastAfter + 1, false);
+  deletedLineSet.assign(lastBefore + 1, false);
+  /* The first entry wins, as with a scan of lineMap */
+  for (auto &iter : lineMap) {
+    if (beforeToAfter[iter.beforeIdx] == noLine) {
+      beforeToAfter[iter.beforeIdx] = iter.afterIdx;
+    } // End check for beforeToAfter
+    if (afterToBefore[iter.afterIdx] == noLine) {
+      afterToBefore[iter.afterIdx] = iter.beforeIdx;
+    } // End check for afterToBefore
+    if (iter.type == SES_ADD) {
+      addedLineSet[iter.afterIdx] = true;
+    } else if (iter.type == SES_DELETE) {
+      deletedLineSet[iter.beforeIdx] = true;
+    } // End check for iter.type
   }   // End loop for lineMap
-  return std::numeric_limits<unsigned>::max();
-} // End getOldLineNumber
+} // End indexMapping
 } // namespace hydrogen_framework
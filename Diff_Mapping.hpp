@@ -8,6 +8,7 @@
 
 #include "Diff_Util.hpp"
 #include <iostream>
+#include <limits>
 #include <list>
 #include <regex>
 #include <vector>
@@ -30,32 +31,37 @@ public:
   /**
    * Populate line mapping
    */
-  void putMapping(std::vector<sesElem> seqVector);
+  void putMapping(const std::vector<sesElem> &seqVector);
+
+  /**
+   * Populate line mapping from the runs of an edit script
+   */
+  void putMapping(const editScript &script);
 
   /**
    * Return lineMap
    */
-  std::list<elemInfo> getMapping() { return lineMap; }
+  const std::vector<elemInfo> &getMapping() const { return lineMap; }
 
   /**
    * Return fileName
    */
-  std::string getFileName() { return fileName; }
+  std::string getFileName() const { return fileName; }
 
   /**
    * Return addedLines
    */
-  std::list<long long> getAddedLines() { return addedLines; }
+  const std::vector<long long> &getAddedLines() const { return addedLines; }
 
   /**
    * Return deletedLines
    */
-  std::list<long long> getDeletedLines() { return deletedLines; }
+  const std::vector<long long> &getDeletedLines() const { return deletedLines; }
 
   /**
-   * Return matchedLines
+   * Return matchedLines, in increasing order of the before line
    */
-  std::map<long long, long long> getMatchedLines() { return matchedLines; }
+  const std::vector<std::pair<long long, long long>> &getMatchedLines() const { return matchedLines; }
 
   /**
    * Print lineMap
@@ -86,21 +92,60 @@ public:
    * Get the afterIdx line number given the beforeIdx line number
    * Return unsigned MAX if line not found
    */
-  long long getAfterLineNumber(long long currLine);
+  long long getAfterLineNumber(long long currLine) const {
+    return currLine >= 0 && currLine < static_cast<long long>(beforeToAfter.size()) ? beforeToAfter[currLine] : noLine;
+  }
 
   /**
    * Get the beforeIdx line number given the afterIdx line number
    * Return unsigned MAX if line not found
    */
-  long long getBeforeLineNumber(long long currLine);
+  long long getBeforeLineNumber(long long currLine) const {
+    return currLine >= 0 && currLine < static_cast<long long>(afterToBefore.size()) ? afterToBefore[currLine] : noLine;
+  }
+
+  /**
+   * Return TRUE if currLine of the after file was added
+   */
+  bool isAddedLine(long long currLine) const {
+    return currLine > 0 && currLine < static_cast<long long>(addedLineSet.size()) && addedLineSet[currLine];
+  }
+
+  /**
+   * Return TRUE if currLine of the before file was deleted
+   */
+  bool isDeletedLine(long long currLine) const {
+    return currLine > 0 && currLine < static_cast<long long>(deletedLineSet.size()) && deletedLineSet[currLine];
+  }
 
 private:
-  std::string fileName;              /**< File Name */
-  std::list<elemInfo> lineMap;       /**< Container for line mapping */
-  std::list<long long> addedLines;   /**< Container for added line numbers */
-  std::list<long long> deletedLines; /**< Container for deleted line numbers */
-  std::map<long long, long long>
-      matchedLines; /**< Container for matched line numbers mapping from before to after lines*/
-};                  // End Diff_Mapping Class
+  /**
+   * Rebuild the line translation arrays and line sets from lineMap
+   */
+  void indexMapping();
+
+  /**
+   * Line number returned when a line is not found
+   */
+  static const long long noLine = std::numeric_limits<unsigned>::max();
+
+  /**
+   * Reserve room for the given numbers of added, deleted and matched lines on top of those already mapped
+   */
+  void reserveMapping(std::size_t added, std::size_t deleted, std::size_t matched);
+
+  std::string fileName;                /**< File Name */
+  std::vector<elemInfo> lineMap;       /**< Container for line mapping */
+  std::vector<long long> addedLines;   /**< Container for added line numbers */
+  std::vector<long long> deletedLines; /**< Container for deleted line numbers */
+  /** Container for matched line numbers mapping from before to after lines */
+  std::vector<std::pair<long long, long long>> matchedLines;
+  /** afterIdx of the first lineMap entry for each beforeIdx, noLine if there is none */
+  std::vector<long long> beforeToAfter;
+  /** beforeIdx of the first lineMap entry for each afterIdx, noLine if there is none */
+  std::vector<long long> afterToBefore;
+  std::vector<bool> addedLineSet;   /**< Set of added line numbers of the after file */
+  std::vector<bool> deletedLineSet; /**< Set of deleted line numbers of the before file */
+};                                  // End Diff_Mapping Class
 } // namespace hydrogen_framework
 #endif
@@ -0,0 +1,179 @@
+/**
+ * @file
+ * Implementing Diff_Patch.hpp
+ */
+#include "Diff_Patch.hpp"
+#include <boost/filesystem.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+namespace hydrogen_framework {
+/**
+ * Read a hunk range of the form <first>[,<count>] at cursor and move cursor past it
+ * Returns FALSE if there is no number at cursor
+ */
+static bool readHunkRange(const char *&cursor, long long &first, long long &count) {
+  char *end;
+  first = std::strtoll(cursor, &end, 10);
+  if (end == cursor) {
+    return false;
+  } // End check for first
+  count = 1;
+  if (*end == ',') {
+    cursor = end + 1;
+    count = std::strtoll(cursor, &end, 10);
+    if (end == cursor) {
+      return false;
+    } // End check for count
+  }   // End check for count separator
+  cursor = end;
+  /* An empty range names the line before it */
+  if (count == 0) {
+    ++first;
+  } // End check for empty range
+  return true;
+} // End readHunkRange
+
+std::string Diff_Patch::getHeaderPath(const std::string &line) {
+  std::string path = line.substr(4);
+  std::size_t tab = path.find('\t');
+  if (tab != std::string::npos) {
+    path.erase(tab);
+  } // End check for timestamp
+  if (path.size() >= 2 && path[0] == '"' && path[path.size() - 1] == '"') {
+    path = path.substr(1, path.size() - 2);
+  } // End check for quoted path
+  if (path == "/dev/null") {
+    return "";
+  } // End check for missing file
+  if (path.compare(0, 2, "a/") == 0 || path.compare(0, 2, "b/") == 0) {
+    path.erase(0, 2);
+  } // End check for git prefix
+  return path;
+} // End getHeaderPath
+
+std::string Diff_Patch::getFileName(const Patch_File &file) {
+  return boost::filesystem::path(file.afterPath.empty() ? file.beforePath : file.afterPath).filename().string();
+} // End getFileName
+
+bool Diff_Patch::readPatchFile(std::string path) {
+  std::ifstream input(path.c_str());
+  if (!input.is_open()) {
+    std::cerr << "Unable to open patch " << path << "\n";
+    return false;
+  } // End check for input
+  return readPatch(input);
+} // End readPatchFile
+
+bool Diff_Patch::readGitDiff(std::string repository, std::string fromRev, std::string toRev) {
+  /* Single quote every argument for the shell */
+  std::string command = "git";
+  for (auto &arg : {std::string("-C"), repository, std::string("diff"), std::string("--no-color"),
+                    std::string("--no-ext-diff"), std::string("-U0"), fromRev, toRev}) {
+    std::string quoted = "'";
+    for (char c : arg) {
+      if (c == '\'') {
+        quoted += "'\\''";
+      } else {
+        quoted += c;
+      } // End check for quote
+    }   // End loop for arg
+    command += " " + quoted + "'";
+  } // End loop for arguments
+  FILE *pipe = popen(command.c_str(), "r");
+  if (!pipe) {
+    std::cerr << "Unable to run " << command << "\n";
+    return false;
+  } // End check for pipe
+  std::string output;
+  char buffer[65536];
+  std::size_t bytes;
+  while ((bytes = fread(buffer, 1, sizeof(buffer), pipe)) > 0) {
+    output.append(buffer, bytes);
+  } // End loop for pipe
+  if (pclose(pipe) != 0) {
+    std::cerr << "git diff failed for " << repository << " " << fromRev << " " << toRev << "\n";
+    return false;
+  } // End check for pclose
+  std::istringstream input(output);
+  return readPatch(input);
+} // End readGitDiff
+
+bool Diff_Patch::readPatch(std::istream &input) {
+  std::string line;
+  std::string beforeHeader;
+  while (std::getline(input, line)) {
+    if (line.compare(0, 4, "--- ") == 0) {
+      beforeHeader = line;
+      continue;
+    } // End check for before header
+    if (line.compare(0, 4, "+++ ") == 0 && !beforeHeader.empty()) {
+      Patch_File file;
+      file.beforePath = getHeaderPath(beforeHeader);
+      file.afterPath = getHeaderPath(line);
+      file.beforeEnd = 1;
+      file.afterEnd = 1;
+      patchFiles.push_back(file);
+      beforeHeader.clear();
+      continue;
+    } // End check for after header
+    beforeHeader.clear();
+    if (line.compare(0, 3, "@@ ") != 0) {
+      /* diff --git, index, mode and rename lines carry nothing for the mapping */
+      continue;
+    } // End check for hunk header
+    long long beforeLine, beforeCount, afterLine, afterCount;
+    const char *cursor = line.c_str() + 3;
+    if (patchFiles.empty() || *cursor++ != '-' || !readHunkRange(cursor, beforeLine, beforeCount) ||
+        *cursor++ != ' ' || *cursor++ != '+' || !readHunkRange(cursor, afterLine, afterCount)) {
+      std::cerr << "Malformed hunk header " << line << "\n";
+      return false;
+    } // End check for hunk header
+    Patch_File &file = patchFiles.back();
+    /* Lines since the last hunk are common, so both sides skip the same number */
+    if (beforeLine < file.beforeEnd || afterLine < file.afterEnd ||
+        beforeLine - file.beforeEnd != afterLine - file.afterEnd) {
+      std::cerr << "Hunk " << line << " does not follow the previous hunk\n";
+      return false;
+    } // End check for hunk position
+    Diff_Vars::appendEdit(file.edits, Diff_Vars::SES_COMMON, file.beforeEnd, file.afterEnd,
+                          beforeLine - file.beforeEnd);
+    /* The counts tell where the hunk ends, so lines such as "--- x" inside it are not headers */
+    while ((beforeCount > 0 || afterCount > 0) && std::getline(input, line)) {
+      char kind = line.empty() ? ' ' : line[0];
+      if (kind == ' ' && beforeCount > 0 && afterCount > 0) {
+        Diff_Vars::appendEdit(file.edits, Diff_Vars::SES_COMMON, beforeLine++, afterLine++, 1);
+        --beforeCount;
+        --afterCount;
+      } else if (kind == '-' && beforeCount > 0) {
+        Diff_Vars::appendEdit(file.edits, Diff_Vars::SES_DELETE, beforeLine++, 0, 1);
+        --beforeCount;
+      } else if (kind == '+' && afterCount > 0) {
+        Diff_Vars::appendEdit(file.edits, Diff_Vars::SES_ADD, 0, afterLine++, 1);
+        --afterCount;
+      } else if (kind != '\\') {
+        std::cerr << "Unexpected line in hunk: " << line << "\n";
+        return false;
+      } // End check for kind
+    }   // End loop for hunk lines
+    if (beforeCount > 0 || afterCount > 0) {
+      std::cerr << "Patch ends inside a hunk\n";
+      return false;
+    } // End check for truncated hunk
+    file.beforeEnd = beforeLine;
+    file.afterEnd = afterLine;
+  } // End loop for patch lines
+  return true;
+} // End readPatch
+
+Diff_Vars::editScript Diff_Patch::getEditScript(const Patch_File &file, long long beforeLineCount) {
+  Diff_Vars::editScript script = file.edits;
+  if (!file.afterPath.empty() && !file.beforePath.empty()) {
+    Diff_Vars::appendEdit(script, Diff_Vars::SES_COMMON, file.beforeEnd, file.afterEnd,
+                          beforeLineCount - file.beforeEnd + 1);
+  } // End check for file on both sides
+  return script;
+} // End getEditScript
+} // namespace hydrogen_framework
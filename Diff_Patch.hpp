@@ -0,0 +1,79 @@
+/**
+ * @file
+ * Diff_Patch Class: Line edits of the files changed by a unified diff
+ */
+#ifndef DIFF_PATCH_H
+#define DIFF_PATCH_H
+
+#include "Diff_Util.hpp"
+#include <istream>
+#include <string>
+#include <vector>
+namespace hydrogen_framework {
+/**
+ * Patch_File: Edits of one file of a unified diff
+ * Lines between hunks are recorded as common, lines after the last hunk are not recorded
+ */
+struct Patch_File {
+  std::string beforePath;      /**< Path before the change. Empty for an added file */
+  std::string afterPath;       /**< Path after the change. Empty for a deleted file */
+  Diff_Vars::editScript edits; /**< Runs of lines up to the last hunk, with line numbers of the whole file */
+  long long beforeEnd;         /**< Line after the last before line covered by a hunk */
+  long long afterEnd;          /**< Line after the last after line covered by a hunk */
+};
+
+/**
+ * Diff_Patch Class: Reads a unified diff, as written by diff -u or git diff, into Patch_File records
+ * Only the patch is read. The files it changes are not opened
+ */
+class Diff_Patch {
+public:
+  /**
+   * Constructor
+   */
+  Diff_Patch() {}
+
+  /**
+   * Read the unified diff at path
+   * Returns FALSE if the file cannot be read or is not a well formed unified diff
+   */
+  bool readPatchFile(std::string path);
+
+  /**
+   * Read the output of git diff between the revisions fromRev and toRev of the git repository at repository
+   * Returns FALSE if git fails or its output is not a well formed unified diff
+   */
+  bool readGitDiff(std::string repository, std::string fromRev, std::string toRev);
+
+  /**
+   * Read a unified diff from input
+   * Returns FALSE if the diff is not well formed
+   */
+  bool readPatch(std::istream &input);
+
+  /**
+   * Return the changed files in patch order
+   */
+  const std::vector<Patch_File> &getPatchFiles() const { return patchFiles; }
+
+  /**
+   * Return the file name the changed file is known by in Diff_Mapping
+   */
+  static std::string getFileName(const Patch_File &file);
+
+  /**
+   * Return the edit script of the whole of file, given beforeLineCount lines before the change
+   * Lines between and after the hunks are common. beforeLineCount is raised to the end of the last hunk
+   */
+  static Diff_Vars::editScript getEditScript(const Patch_File &file, long long beforeLineCount);
+
+private:
+  /**
+   * Return the path of a ---/+++ header line without its prefix, a/ or b/ and timestamp. Empty for /dev/null
+   */
+  static std::string getHeaderPath(const std::string &line);
+
+  std::vector<Patch_File> patchFiles; /**< Changed files */
+};                                    // End Diff_Patch Class
+} // namespace hydrogen_framework
+#endif
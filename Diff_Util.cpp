@@ -4,7 +4,30 @@
  * Implementing Diff_Util.hpp
  */
 #include "Diff_Util.hpp"
+#include "Parallel_Util.hpp"
+#include <algorithm>
 namespace hydrogen_framework {
+/**
+ * Work item of Diff_Util::composeLinear
+ * Either a range of lines of A and B left to diff, or a run of common lines to record once the ranges before it are
+ */
+struct Diff_Linear_Task {
+  bool common;        /**< TRUE if the task records the lines as common */
+  std::size_t aFirst; /**< First line of A */
+  std::size_t aLast;  /**< Line of A after the last one */
+  std::size_t bFirst; /**< First line of B */
+  std::size_t bLast;  /**< Line of B after the last one */
+};
+
+/**
+ * Occurrences of a line in the before and after sequences while looking for anchors
+ */
+struct Diff_Anchor_Count {
+  std::size_t beforeCount; /**< Number of occurrences before */
+  std::size_t afterCount;  /**< Number of occurrences after */
+  std::size_t beforeIdx;   /**< Index of the last occurrence before */
+  std::size_t afterIdx;    /**< Index of the last occurrence after */
+};
 void Diff_Ses::addSequence(elem e, long long beforeIdx, long long afterIdx, const int type) {
   elemInfo info;
   info.beforeIdx = beforeIdx;
@@ -41,13 +64,98 @@ void Diff_Ses::addSequence(elem e, long long beforeIdx, long long afterIdx, cons
   } // End switch for SES_DELETE
 } // End addSequence
 
+Diff_Util::Diff_Util(const sequence &a, const sequence &b)
+    : ownedA(a), ownedB(b), ses(false), sesBuilt(false), diffMode(DIFF_TEXT), diffAlgorithm(DIFF_AUTO) {
+  ownedLinesA.reserve(ownedA.size());
+  for (auto &line : ownedA) {
+    ownedLinesA.push_back(Diff_Line(line.data(), line.size()));
+  } // End loop for ownedA
+  ownedLinesB.reserve(ownedB.size());
+  for (auto &line : ownedB) {
+    ownedLinesB.push_back(Diff_Line(line.data(), line.size()));
+  } // End loop for ownedB
+  A = ownedLinesA.data();
+  B = ownedLinesB.data();
+  M = ownedLinesA.size();
+  N = ownedLinesB.size();
+  init();
+} // End Diff_Util
+
+uint64_t Diff_Util::hashLine(const Diff_Line &line) {
+  uint64_t hash = 14695981039346656037ULL;
+  for (std::size_t index = 0; index < line.size; ++index) {
+    hash ^= static_cast<unsigned char>(line.data[index]);
+    hash *= 1099511628211ULL;
+  } // End loop for line
+  return hash;
+} // End hashLine
+
+void Diff_Util::hashLines() {
+  hashA.resize(sizeA);
+  for (std::size_t index = 0; index < sizeA; ++index) {
+    hashA[index] = hashLine(A[index]);
+  } // End loop for A
+  hashB.resize(sizeB);
+  for (std::size_t index = 0; index < sizeB; ++index) {
+    hashB[index] = hashLine(B[index]);
+  } // End loop for B
+} // End hashLines
+
+void Diff_Util::addEdit(int type, long long beforeIdx, long long afterIdx, long long count) {
+  appendEdit(script, type, beforeIdx, afterIdx, count);
+} // End addEdit
+
+void Diff_Vars::appendEdit(editScript &script, int type, long long beforeIdx, long long afterIdx, long long count) {
+  if (count <= 0) {
+    return;
+  } // End check for count
+  if (!script.empty()) {
+    editRange &last = script.back();
+    if (last.type == type && (type == SES_ADD || last.beforeIdx + last.count == beforeIdx) &&
+        (type == SES_DELETE || last.afterIdx + last.count == afterIdx)) {
+      last.count += count;
+      return;
+    } // End check for continued run
+  }   // End check for script
+  editRange edit;
+  edit.type = type;
+  edit.beforeIdx = beforeIdx;
+  edit.afterIdx = afterIdx;
+  edit.count = count;
+  script.push_back(edit);
+} // End appendEdit
+
+const Diff_Ses &Diff_Util::getSes() {
+  if (sesBuilt) {
+    return ses;
+  } // End check for sesBuilt
+  sesBuilt = true;
+  const Diff_Line *before = wasSwapped() ? B : A;
+  const Diff_Line *after = wasSwapped() ? A : B;
+  for (auto &edit : script) {
+    for (long long index = 0; index < edit.count; ++index) {
+      long long beforeIdx = edit.beforeIdx ? edit.beforeIdx + index : 0;
+      long long afterIdx = edit.afterIdx ? edit.afterIdx + index : 0;
+      const Diff_Line &line = edit.type == SES_ADD ? after[afterIdx - 1] : before[beforeIdx - 1];
+      ses.addSequence(line.str(), beforeIdx, afterIdx, edit.type);
+    } // End loop for edit
+  }   // End loop for script
+  return ses;
+} // End getSes
+
 void Diff_Util::compose() {
-  pathCordinates.reserve(MAX_CORDINATES_SIZE);
+  if (diffMode == DIFF_HASHED) {
+    hashLines();
+  } // End check for DIFF_HASHED
+  if (diffAlgorithm == DIFF_LINEAR_SPACE) {
+    composeLinear();
+    return;
+  } // End check for diffAlgorithm
+  pathCordinates.reserve(std::min(static_cast<unsigned long long>(M + N + 3), MAX_CORDINATES_SIZE));
   long long p = -1;
-  fp = new long long[M + N + 3];
-  std::fill(&fp[0], &fp[M + N + 3], -1);
-  path = editPath(M + N + 3);
-  fill(path.begin(), path.end(), -1);
+  /* fp and path are sized once, reusing the storage of an earlier compose. A restart only works on the lines left */
+  fp.assign(M + N + 3, -1);
+  path.assign(M + N + 3, -1);
 ONP:
   do {
     ++p;
@@ -62,28 +170,41 @@ ONP:
 
   long long r = path[delta + offset];
   P cordinate;
-  editPathCordinates epc(0);
+  tracedPath.clear();
 
   while (r != -1) {
     cordinate.x = pathCordinates[(size_t)r].x;
     cordinate.y = pathCordinates[(size_t)r].y;
-    epc.push_back(cordinate);
+    tracedPath.push_back(cordinate);
     r = pathCordinates[(size_t)r].k;
   } // End loop for r!= -1
 
   // Record Longest Common Subsequence & Shortest Edit Script
-  if (!recordSequence(epc)) {
-    pathCordinates.resize(0);
-    epc.resize(0);
+  if (!recordSequence(tracedPath)) {
+    if (diffAlgorithm == DIFF_AUTO) {
+      /* The trace outgrew MAX_CORDINATES_SIZE. The lines left are diffed in linear space instead of restarting */
+      composeLinear();
+      return;
+    } // End check for DIFF_AUTO
+    pathCordinates.clear();
     p = -1;
     goto ONP;
   } // End check for recordSequence
-  delete[] this->fp;
 } // End compose
 
+void Diff_Util::resetLines(const Diff_Line *a, std::size_t aSize, const Diff_Line *b, std::size_t bSize) {
+  A = a;
+  B = b;
+  M = aSize;
+  N = bSize;
+  script.clear();
+  pathCordinates.clear();
+  ses.clearSequence();
+  sesBuilt = false;
+  init();
+} // End resetLines
+
 void Diff_Util::init() {
-  M = distance(A.begin(), A.end());
-  N = distance(B.begin(), B.end());
   if (M < N) {
     swapped = false;
   } else {
@@ -91,20 +212,35 @@ void Diff_Util::init() {
     std::swap(M, N);
     swapped = true;
   } // End check for M < N
+  sizeA = M;
+  sizeB = N;
+  doneA = doneB = 0;
   delta = N - M;
   offset = M + 1;
-  fp = NULL;
 } // End init
 
 long long Diff_Util::snake(const long long &k, const long long &above, const long long &below) {
   long long r = above > below ? path[(size_t)k - 1 + offset] : path[(size_t)k + 1 + offset];
   long long y = std::max(above, below);
   long long x = y - k;
-  while ((size_t)x < M && (size_t)y < N &&
-         (swapped ? cmp.impl(B[(size_t)y], A[(size_t)x]) : cmp.impl(A[(size_t)x], B[(size_t)y]))) {
-    ++x;
-    ++y;
-  } // End loop for swapped
+  /* Lines left after a restart */
+  const Diff_Line *lineX = A + doneA;
+  const Diff_Line *lineY = B + doneB;
+  if (diffMode == DIFF_HASHED) {
+    /* Equal lines have equal hashes. The text is only compared to rule out a collision */
+    const uint64_t *hashX = hashA.data() + doneA;
+    const uint64_t *hashY = hashB.data() + doneB;
+    while ((size_t)x < M && (size_t)y < N && hashX[x] == hashY[y] && lineX[x].size == lineY[y].size &&
+           std::memcmp(lineX[x].data, lineY[y].data, lineX[x].size) == 0) {
+      ++x;
+      ++y;
+    } // End loop for hashes
+  } else {
+    while ((size_t)x < M && (size_t)y < N && (swapped ? cmp.impl(lineY[y], lineX[x]) : cmp.impl(lineX[x], lineY[y]))) {
+      ++x;
+      ++y;
+    } // End loop for swapped
+  }   // End check for diffMode
 
   path[(size_t)k + offset] = static_cast<long long>(pathCordinates.size());
   P p;
@@ -116,41 +252,36 @@ long long Diff_Util::snake(const long long &k, const long long &above, const lon
 } // End snake
 
 bool Diff_Util::recordSequence(const editPathCordinates &v) {
-  sequence_const_iter x(A.begin());
-  sequence_const_iter y(B.begin());
   long long x_idx, y_idx;   // line number for Unified Format
   long long px_idx, py_idx; // cordinates
   bool complete = false;
-  x_idx = y_idx = 1;
+  x_idx = static_cast<long long>(doneA) + 1;
+  y_idx = static_cast<long long>(doneB) + 1;
   px_idx = py_idx = 0;
   for (size_t i = v.size() - 1; !complete; --i) {
     while (px_idx < v[i].x || py_idx < v[i].y) {
       if (v[i].y - v[i].x > py_idx - px_idx) {
         if (!wasSwapped()) {
-          ses.addSequence(*y, 0, y_idx, SES_ADD);
+          addEdit(SES_ADD, 0, y_idx, 1);
         } else {
-          ses.addSequence(*y, y_idx, 0, SES_DELETE);
+          addEdit(SES_DELETE, y_idx, 0, 1);
         } // End check for wasSwapped
-        ++y;
         ++y_idx;
         ++py_idx;
       } else if (v[i].y - v[i].x < py_idx - px_idx) {
         if (!wasSwapped()) {
-          ses.addSequence(*x, x_idx, 0, SES_DELETE);
+          addEdit(SES_DELETE, x_idx, 0, 1);
         } else {
-          ses.addSequence(*x, 0, x_idx, SES_ADD);
+          addEdit(SES_ADD, 0, x_idx, 1);
         } // End check for wasSwapped
-        ++x;
         ++x_idx;
         ++px_idx;
       } else {
         if (!wasSwapped()) {
-          ses.addSequence(*x, x_idx, y_idx, SES_COMMON);
+          addEdit(SES_COMMON, x_idx, y_idx, 1);
         } else {
-          ses.addSequence(*y, y_idx, x_idx, SES_COMMON);
+          addEdit(SES_COMMON, y_idx, x_idx, 1);
         } // End check for wasSwapped
-        ++x;
-        ++y;
         ++x_idx;
         ++y_idx;
         ++px_idx;
@@ -161,23 +292,313 @@ bool Diff_Util::recordSequence(const editPathCordinates &v) {
       complete = true;
   } // End loop for complete
 
-  if (x_idx > static_cast<long long>(M) && y_idx > static_cast<long long>(N)) {
+  if (x_idx > static_cast<long long>(sizeA) && y_idx > static_cast<long long>(sizeB)) {
     // all recording succeeded
   } else {
-    sequence A_(A.begin() + (size_t)x_idx - 1, A.end());
-    sequence B_(B.begin() + (size_t)y_idx - 1, B.end());
-    A = A_;
-    B = B_;
-    M = distance(A.begin(), A.end());
-    N = distance(B.begin(), B.end());
+    /* Continue with the lines left, without copying them */
+    doneA = (size_t)x_idx - 1;
+    doneB = (size_t)y_idx - 1;
+    M = sizeA - doneA;
+    N = sizeB - doneB;
     delta = N - M;
     offset = M + 1;
-    delete[] fp;
-    fp = new long long[M + N + 3];
-    std::fill(&fp[0], &fp[M + N + 3], -1);
+    std::fill(fp.begin(), fp.begin() + (M + N + 3), -1);
     std::fill(path.begin(), path.end(), -1);
     return false;
   } // End check for x_idx
   return true;
-} // End snake
+} // End recordSequence
+
+void Diff_Util::addLinearEdit(int type, size_t x, size_t y, size_t count) {
+  if (!count) {
+    return;
+  } // End check for count
+  long long lineX = static_cast<long long>(x) + 1;
+  long long lineY = static_cast<long long>(y) + 1;
+  long long lines = static_cast<long long>(count);
+  switch (type) {
+  case SES_DELETE:
+    if (!wasSwapped()) {
+      addEdit(SES_DELETE, lineX, 0, lines);
+    } else {
+      addEdit(SES_ADD, 0, lineX, lines);
+    } // End check for wasSwapped
+    break;
+  case SES_ADD:
+    if (!wasSwapped()) {
+      addEdit(SES_ADD, 0, lineY, lines);
+    } else {
+      addEdit(SES_DELETE, lineY, 0, lines);
+    } // End check for wasSwapped
+    break;
+  case SES_COMMON:
+    if (!wasSwapped()) {
+      addEdit(SES_COMMON, lineX, lineY, lines);
+    } else {
+      addEdit(SES_COMMON, lineY, lineX, lines);
+    } // End check for wasSwapped
+    break;
+  } // End switch for type
+} // End addLinearEdit
+
+bool Diff_Util::splitLinear(size_t aFirst, size_t aLast, size_t bFirst, size_t bLast, size_t &x, size_t &y) {
+  long long sizeX = static_cast<long long>(aLast - aFirst);
+  long long sizeY = static_cast<long long>(bLast - bFirst);
+  long long maxD = (sizeX + sizeY + 1) / 2;
+  long long vOffset = maxD;
+  long long vLength = 2 * maxD + 2;
+  std::fill(linearForward.begin(), linearForward.begin() + vLength, -1);
+  std::fill(linearBackward.begin(), linearBackward.begin() + vLength, -1);
+  linearForward[vOffset + 1] = 0;
+  linearBackward[vOffset + 1] = 0;
+  long long delta = sizeX - sizeY;
+  /* With an odd delta the forward path reaches the overlap first, otherwise the backward path does */
+  bool front = (delta % 2 != 0);
+  long long forwardStart = 0, forwardEnd = 0, backwardStart = 0, backwardEnd = 0;
+  for (long long d = 0; d < maxD; ++d) {
+    for (long long k = -d + forwardStart; k <= d - forwardEnd; k += 2) {
+      long long kOffset = vOffset + k;
+      long long forwardX;
+      if (k == -d || (k != d && linearForward[kOffset - 1] < linearForward[kOffset + 1])) {
+        forwardX = linearForward[kOffset + 1];
+      } else {
+        forwardX = linearForward[kOffset - 1] + 1;
+      } // End check for down or right
+      long long forwardY = forwardX - k;
+      while (forwardX < sizeX && forwardY < sizeY && sameLine(aFirst + forwardX, bFirst + forwardY)) {
+        ++forwardX;
+        ++forwardY;
+      } // End loop for forward snake
+      linearForward[kOffset] = forwardX;
+      if (forwardX > sizeX) {
+        forwardEnd += 2;
+      } else if (forwardY > sizeY) {
+        forwardStart += 2;
+      } else if (front) {
+        long long backwardOffset = vOffset + delta - k;
+        if (backwardOffset >= 0 && backwardOffset < vLength && linearBackward[backwardOffset] != -1 &&
+            forwardX >= sizeX - linearBackward[backwardOffset]) {
+          x = forwardX;
+          y = forwardY;
+          return true;
+        } // End check for overlap
+      }   // End check for forward bounds
+    }     // End loop for forward diagonals
+    for (long long k = -d + backwardStart; k <= d - backwardEnd; k += 2) {
+      long long kOffset = vOffset + k;
+      long long backwardX;
+      if (k == -d || (k != d && linearBackward[kOffset - 1] < linearBackward[kOffset + 1])) {
+        backwardX = linearBackward[kOffset + 1];
+      } else {
+        backwardX = linearBackward[kOffset - 1] + 1;
+      } // End check for up or left
+      long long backwardY = backwardX - k;
+      while (backwardX < sizeX && backwardY < sizeY &&
+             sameLine(aLast - 1 - backwardX, bLast - 1 - backwardY)) {
+        ++backwardX;
+        ++backwardY;
+      } // End loop for backward snake
+      linearBackward[kOffset] = backwardX;
+      if (backwardX > sizeX) {
+        backwardEnd += 2;
+      } else if (backwardY > sizeY) {
+        backwardStart += 2;
+      } else if (!front) {
+        long long forwardOffset = vOffset + delta - k;
+        if (forwardOffset >= 0 && forwardOffset < vLength && linearForward[forwardOffset] != -1 &&
+            linearForward[forwardOffset] >= sizeX - backwardX) {
+          x = linearForward[forwardOffset];
+          y = vOffset + linearForward[forwardOffset] - forwardOffset;
+          return true;
+        } // End check for overlap
+      }   // End check for backward bounds
+    }     // End loop for backward diagonals
+  }       // End loop for d
+  return false;
+} // End splitLinear
+
+void Diff_Util::composeLinear() {
+  /* Diagonal arrays for the lines left, which may follow a part recorded by DIFF_ONP. Every later range is smaller */
+  linearForward.assign(M + N + 4, -1);
+  linearBackward.assign(M + N + 4, -1);
+  std::vector<Diff_Linear_Task> tasks;
+  Diff_Linear_Task whole = {false, doneA, sizeA, doneB, sizeB};
+  tasks.push_back(whole);
+  while (!tasks.empty()) {
+    Diff_Linear_Task task = tasks.back();
+    tasks.pop_back();
+    if (task.common) {
+      addLinearEdit(SES_COMMON, task.aFirst, task.bFirst, task.aLast - task.aFirst);
+      continue;
+    } // End check for common run
+    /* Common prefix is recorded now, common suffix after the rest of the range */
+    size_t prefix = 0;
+    while (task.aFirst + prefix < task.aLast && task.bFirst + prefix < task.bLast &&
+           sameLine(task.aFirst + prefix, task.bFirst + prefix)) {
+      ++prefix;
+    } // End loop for prefix
+    addLinearEdit(SES_COMMON, task.aFirst, task.bFirst, prefix);
+    task.aFirst += prefix;
+    task.bFirst += prefix;
+    size_t suffix = 0;
+    while (task.aLast - suffix > task.aFirst && task.bLast - suffix > task.bFirst &&
+           sameLine(task.aLast - suffix - 1, task.bLast - suffix - 1)) {
+      ++suffix;
+    } // End loop for suffix
+    if (suffix) {
+      Diff_Linear_Task suffixTask = {true, task.aLast - suffix, task.aLast, task.bLast - suffix, task.bLast};
+      tasks.push_back(suffixTask);
+      task.aLast -= suffix;
+      task.bLast -= suffix;
+    } // End check for suffix
+    size_t x, y;
+    if (task.aFirst == task.aLast || task.bFirst == task.bLast ||
+        !splitLinear(task.aFirst, task.aLast, task.bFirst, task.bLast, x, y) || (x == 0 && y == 0) ||
+        (task.aFirst + x == task.aLast && task.bFirst + y == task.bLast)) {
+      /* Nothing in common, or no split that makes progress */
+      addLinearEdit(SES_DELETE, task.aFirst, 0, task.aLast - task.aFirst);
+      addLinearEdit(SES_ADD, 0, task.bFirst, task.bLast - task.bFirst);
+      continue;
+    } // End check for split
+    Diff_Linear_Task second = {false, task.aFirst + x, task.aLast, task.bFirst + y, task.bLast};
+    Diff_Linear_Task first = {false, task.aFirst, task.aFirst + x, task.bFirst, task.bFirst + y};
+    tasks.push_back(second);
+    tasks.push_back(first);
+  } // End loop for tasks
+} // End composeLinear
+
+void Diff_Util::composeAnchored(unsigned threadCount) {
+  /* init may have swapped the sequences. Anchors are found in the original order */
+  const Diff_Line *before = wasSwapped() ? B : A;
+  const Diff_Line *after = wasSwapped() ? A : B;
+  std::size_t beforeSize = wasSwapped() ? sizeB : sizeA;
+  std::size_t afterSize = wasSwapped() ? sizeA : sizeB;
+  std::size_t prefix = 0;
+  while (prefix < beforeSize && prefix < afterSize && cmp.impl(before[prefix], after[prefix])) {
+    ++prefix;
+  } // End loop for prefix
+  std::size_t suffix = 0;
+  while (suffix < beforeSize - prefix && suffix < afterSize - prefix &&
+         cmp.impl(before[beforeSize - 1 - suffix], after[afterSize - 1 - suffix])) {
+    ++suffix;
+  } // End loop for suffix
+  std::size_t beforeEnd = beforeSize - suffix;
+  std::size_t afterEnd = afterSize - suffix;
+  /* Lines occurring once on each side, counted in an open addressing table that is sized once */
+  std::size_t tableSize = 1;
+  while (tableSize < 2 * (beforeEnd - prefix)) {
+    tableSize <<= 1;
+  } // End loop for tableSize
+  std::vector<Diff_Anchor_Count> counts(tableSize, Diff_Anchor_Count());
+  /* A slot is empty until a line of before is counted in it */
+  auto findSlot = [&](const Diff_Line &line) -> Diff_Anchor_Count & {
+    std::size_t slot = static_cast<std::size_t>(hashLine(line)) & (tableSize - 1);
+    while (counts[slot].beforeCount && !cmp.impl(before[counts[slot].beforeIdx], line)) {
+      slot = (slot + 1) & (tableSize - 1);
+    } // End loop for probing
+    return counts[slot];
+  };
+  for (std::size_t index = prefix; index < beforeEnd; ++index) {
+    Diff_Anchor_Count &count = findSlot(before[index]);
+    ++count.beforeCount;
+    count.beforeIdx = index;
+  } // End loop for before
+  for (std::size_t index = prefix; index < afterEnd; ++index) {
+    Diff_Anchor_Count &count = findSlot(after[index]);
+    if (count.beforeCount) {
+      ++count.afterCount;
+      count.afterIdx = index;
+    } // End check for line in before
+  }   // End loop for after
+  std::size_t candidateCount = 0;
+  for (auto &count : counts) {
+    candidateCount += count.beforeCount == 1 && count.afterCount == 1;
+  } // End loop for candidateCount
+  std::vector<std::pair<std::size_t, std::size_t>> candidates;
+  candidates.reserve(candidateCount);
+  for (auto &count : counts) {
+    if (count.beforeCount == 1 && count.afterCount == 1) {
+      candidates.push_back(std::make_pair(count.beforeIdx, count.afterIdx));
+    } // End check for unique line
+  }   // End loop for candidates
+  std::sort(candidates.begin(), candidates.end());
+  std::vector<Diff_Anchor_Count>().swap(counts);
+  /* Longest run of candidates increasing on the after side, by patience sorting */
+  std::vector<std::size_t> tails;
+  tails.reserve(candidates.size());
+  std::vector<long long> previous(candidates.size(), -1);
+  for (std::size_t index = 0; index < candidates.size(); ++index) {
+    auto pile = std::lower_bound(tails.begin(), tails.end(), candidates[index].second,
+                                 [&](std::size_t tail, std::size_t value) { return candidates[tail].second < value; });
+    if (pile != tails.begin()) {
+      previous[index] = static_cast<long long>(*(pile - 1));
+    } // End check for first pile
+    if (pile == tails.end()) {
+      tails.push_back(index);
+    } else {
+      *pile = index;
+    } // End check for new pile
+  }   // End loop for candidates
+  std::vector<std::pair<std::size_t, std::size_t>> anchors;
+  anchors.reserve(tails.size());
+  for (long long index = tails.empty() ? -1 : static_cast<long long>(tails.back()); index != -1;
+       index = previous[(size_t)index]) {
+    anchors.push_back(candidates[(size_t)index]);
+  } // End loop for anchors
+  std::reverse(anchors.begin(), anchors.end());
+  /* Region k ends at anchor k, the last region at the suffix */
+  std::size_t regionCount = anchors.size() + 1;
+  std::vector<std::pair<std::size_t, std::size_t>> regionStarts;
+  std::vector<std::pair<std::size_t, std::size_t>> regionEnds;
+  regionStarts.reserve(regionCount);
+  regionEnds.reserve(regionCount);
+  regionStarts.push_back(std::make_pair(prefix, prefix));
+  for (auto &anchor : anchors) {
+    regionEnds.push_back(anchor);
+    regionStarts.push_back(std::make_pair(anchor.first + 1, anchor.second + 1));
+  } // End loop for anchors
+  regionEnds.push_back(std::make_pair(beforeEnd, afterEnd));
+  /* A few chunks per worker keep the load even while every chunk reuses one Diff_Util for its regions */
+  std::size_t chunkCount = threadCount > 1 ? std::min(regionCount, static_cast<std::size_t>(threadCount) * 4) : 1;
+  std::vector<editScript> chunkScripts(chunkCount);
+  parallelFor(chunkCount, threadCount, [&](std::size_t chunk) {
+    Diff_Util regionDiff;
+    regionDiff.setDiffMode(diffMode);
+    editScript &chunkScript = chunkScripts[chunk];
+    /* Line numbers start at 1 */
+    for (std::size_t region = regionCount * chunk / chunkCount; region < regionCount * (chunk + 1) / chunkCount;
+         ++region) {
+      std::size_t beforeFirst = regionStarts[region].first;
+      std::size_t afterFirst = regionStarts[region].second;
+      std::size_t beforeCount = regionEnds[region].first - beforeFirst;
+      std::size_t afterCount = regionEnds[region].second - afterFirst;
+      if (!afterCount || !beforeCount) {
+        appendEdit(chunkScript, SES_DELETE, beforeFirst + 1, 0, beforeCount);
+        appendEdit(chunkScript, SES_ADD, 0, afterFirst + 1, afterCount);
+      } else {
+        regionDiff.resetLines(before + beforeFirst, beforeCount, after + afterFirst, afterCount);
+        regionDiff.compose();
+        for (auto &edit : regionDiff.getEditScript()) {
+          appendEdit(chunkScript, edit.type, edit.beforeIdx ? edit.beforeIdx + beforeFirst : 0,
+                     edit.afterIdx ? edit.afterIdx + afterFirst : 0, edit.count);
+        } // End loop for region edits
+      }   // End check for region sides
+      if (region < anchors.size()) {
+        appendEdit(chunkScript, SES_COMMON, anchors[region].first + 1, anchors[region].second + 1, 1);
+      } // End check for anchor after region
+    }   // End loop for regions
+  });
+  /* Stitch the chunks together */
+  if (prefix) {
+    addEdit(SES_COMMON, 1, 1, prefix);
+  } // End check for prefix
+  for (auto &chunkScript : chunkScripts) {
+    for (auto &edit : chunkScript) {
+      addEdit(edit.type, edit.beforeIdx, edit.afterIdx, edit.count);
+    } // End loop for chunkScript
+  }   // End loop for chunkScripts
+  if (suffix) {
+    addEdit(SES_COMMON, beforeEnd + 1, afterEnd + 1, suffix);
+  } // End check for suffix
+} // End composeAnchored
 } // namespace hydrogen_framework
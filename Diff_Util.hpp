@@ -6,10 +6,31 @@
 #ifndef DIFF_UTIL_H
 #define DIFF_UTIL_H
 
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <list>
 #include <string>
 #include <vector>
 namespace hydrogen_framework {
+/**
+ * Diff_Line: View of one line held elsewhere, either in a mapped Source_File or in a std::string
+ */
+struct Diff_Line {
+  /**
+   * Constructor
+   */
+  Diff_Line(const char *lineData, std::size_t lineSize) : data(lineData), size(lineSize) {}
+
+  /**
+   * Return the line as a std::string
+   */
+  std::string str() const { return std::string(data, size); }
+
+  const char *data; /**< First character of the line */
+  std::size_t size; /**< Length of the line without its newline */
+};
+
 /**
  * DiffCompare Functor class
  */
@@ -28,6 +49,13 @@ public:
    * Return TRUE if equal
    */
   virtual inline bool impl(const std::string &e1, const std::string &e2) const { return e1 == e2; }
+  /**
+   * Comparison function for line views
+   * Return TRUE if equal
+   */
+  virtual inline bool impl(const Diff_Line &e1, const Diff_Line &e2) const {
+    return e1.size == e2.size && std::memcmp(e1.data, e2.data, e1.size) == 0;
+  }
 };
 
 /**
@@ -69,6 +97,16 @@ public:
     }
   } elemInfo;
 
+  /**
+   * Run of consecutive lines with the same type of edit
+   */
+  typedef struct editrange {
+    int type;            /**< Type of edit(Add, Delete, Common) */
+    long long beforeIdx; /**< Index of the first line of prev sequence. 0 for Add */
+    long long afterIdx;  /**< Index of the first line of after sequence. 0 for Delete */
+    long long count;     /**< Number of lines */
+  } editRange;
+
   /**
    * Coordinate for registering route
    */
@@ -81,12 +119,19 @@ public:
   const unsigned long long MAX_CORDINATES_SIZE = 2000000;        /**< Limit of coordinate size */
   typedef std::vector<long long> editPath;                       /**< Type definition for editPath */
   typedef std::vector<P> editPathCordinates;                     /**< Type definition for editPathCordinates */
+  typedef std::vector<editRange> editScript;                     /**< Type definition for editScript */
   typedef std::string elem;                                      /**< Type definition for elem */
   typedef std::vector<elem> sequence;                            /**< Type definition for sequence */
+  typedef std::vector<Diff_Line> lineSequence;                   /**< Type definition for lineSequence */
   typedef std::pair<elem, elemInfo> sesElem;                     /**< Type definition for sesElem */
   typedef std::vector<sesElem> sesElemVec;                       /**< Type definition for sesElemVec */
   typedef std::list<elem> elemList;                              /**< Type definition for elemList */
   typedef std::vector<elem> elemVec;                             /**< Type definition for elemVec */
+
+  /**
+   * Append count lines of type to script, extending the last run when it continues
+   */
+  static void appendEdit(editScript &script, int type, long long beforeIdx, long long afterIdx, long long count);
   typedef typename sesElemVec::iterator sesElemVec_iter;         /**< Type definition for sesElemVec_iter*/
   typedef typename elemList::iterator elemList_iter;             /**< Type definition for elemList_iter */
   typedef typename sequence::iterator sequence_iter;             /**< Type definition for sequence_iter */
@@ -111,7 +156,7 @@ public:
   /**
    * Return sequence
    */
-  elemVec getSequence() const { return sequence; }
+  const elemVec &getSequence() const { return sequence; }
 
   /**
    * Add to sequence
@@ -176,7 +221,16 @@ public:
   /**
    * Return sequence
    */
-  sesElemVec getSequence() const { return sequenceDS; }
+  const sesElemVec &getSequence() const { return sequenceDS; }
+
+  /**
+   * Remove every element, keeping the storage of sequence
+   */
+  void clearSequence() {
+    sequenceDS.clear();
+    onlyAdd = onlyDelete = onlyCopy = true;
+    nextDeleteIdx = 0;
+  }
 
 private:
   sesElemVec sequenceDS; /**< SES sequence */
@@ -195,12 +249,33 @@ public:
   /**
    * Constructor with no arguments
    */
-  Diff_Util() {}
+  Diff_Util()
+      : A(NULL), B(NULL), M(0), N(0), ses(false), sesBuilt(false), diffMode(DIFF_TEXT), diffAlgorithm(DIFF_AUTO) {
+    init();
+  }
 
   /**
    * Constructor with two arguments
+   * The sequences are copied and diffed through views into the copies
+   */
+  Diff_Util(const sequence &a, const sequence &b);
+
+  /**
+   * Constructor with two line views
+   * The lines are borrowed and must outlive the Diff_Util, as with the lines of a Source_File
+   */
+  Diff_Util(const lineSequence &a, const lineSequence &b) : Diff_Util(a.data(), a.size(), b.data(), b.size()) {}
+
+  /**
+   * Constructor with two arrays of aSize and bSize line views
+   * The lines are borrowed and must outlive the Diff_Util
    */
-  Diff_Util(const sequence &a, const sequence &b) : A(a), B(b), ses(false) { init(); }
+  Diff_Util(const Diff_Line *a, std::size_t aSize, const Diff_Line *b, std::size_t bSize)
+      : A(a), B(b), ses(false), sesBuilt(false), diffMode(DIFF_TEXT), diffAlgorithm(DIFF_AUTO) {
+    M = aSize;
+    N = bSize;
+    init();
+  }
 
   /**
    * Destructor
@@ -208,9 +283,58 @@ public:
   ~Diff_Util() {}
 
   /**
-   * Return ses
+   * Diff_Util may hold views into its own copies of the lines and cannot be copied
    */
-  Diff_Ses getSes() const { return ses; }
+  Diff_Util(const Diff_Util &) = delete;
+
+  /**
+   * Diff_Util may hold views into its own copies of the lines and cannot be assigned
+   */
+  Diff_Util &operator=(const Diff_Util &) = delete;
+
+  /**
+   * Diff aSize line views of a against bSize line views of b on the next compose, dropping the edit script
+   * The buffers of earlier composes are kept, so diffing many small ranges in turn allocates only when a range is
+   * larger than every range before it. The lines are borrowed and must outlive the compose
+   */
+  void resetLines(const Diff_Line *a, std::size_t aSize, const Diff_Line *b, std::size_t bSize);
+
+  /**
+   * Ways of comparing lines in compose
+   */
+  enum diffModes {
+    DIFF_TEXT,  /**< Compare the text of the lines through Diff_Compare */
+    DIFF_HASHED /**< Compare 64-bit hashes of the lines and the text only when the hashes are equal */
+  };
+
+  /**
+   * Set the way lines are compared. Must be called before compose
+   */
+  void setDiffMode(diffModes mode) { diffMode = mode; }
+
+  /**
+   * Algorithms used by compose
+   */
+  enum diffAlgorithms {
+    DIFF_AUTO,        /**< DIFF_ONP until its trace reaches MAX_CORDINATES_SIZE, then DIFF_LINEAR_SPACE for the rest */
+    DIFF_ONP,         /**< Wu, Manber and Myers O(NP) with an edit path of up to MAX_CORDINATES_SIZE coordinates */
+    DIFF_LINEAR_SPACE /**< Myers middle snake divide and conquer in O((N+M)D) time and O(N+M) space */
+  };
+
+  /**
+   * Set the algorithm used by compose. Must be called before compose
+   */
+  void setDiffAlgorithm(diffAlgorithms algorithm) { diffAlgorithm = algorithm; }
+
+  /**
+   * Return the edit script as runs of line indices into the sequences
+   */
+  const editScript &getEditScript() const { return script; }
+
+  /**
+   * Return ses, with a copy of every line of the edit script. Built from the edit script on first use
+   */
+  const Diff_Ses &getSes();
 
   /**
    * Compose Longest Common Subsequence and Shortest Edit Script.
@@ -219,19 +343,88 @@ public:
    */
   void compose();
 
+  /**
+   * Compose the SES like compose, after trimming the common prefix and suffix of the sequences.
+   * What is left is split on the lines that occur exactly once in each sequence, keeping the longest run of them
+   * that appears in the same order in both, as patience diff does. The regions between these anchor lines are
+   * composed on up to threadCount workers and stitched back in order. Use instead of compose
+   * The anchor search allocates a fixed number of buffers. The regions are split into a few contiguous chunks, and
+   * each chunk diffs its regions in turn through one Diff_Util via resetLines and writes one edit script
+   */
+  void composeAnchored(unsigned threadCount);
+
+  /**
+   * Return the FNV-1a hash of line
+   */
+  static uint64_t hashLine(const Diff_Line &line);
+
 private:
-  sequence A;                        /**< First sequence */
-  sequence B;                        /**< Second sequence */
+  sequence ownedA;                   /**< Storage of the first sequence when it was given as strings */
+  sequence ownedB;                   /**< Storage of the second sequence when it was given as strings */
+  lineSequence ownedLinesA;          /**< Views of ownedA */
+  lineSequence ownedLinesB;          /**< Views of ownedB */
+  const Diff_Line *A;                /**< First sequence */
+  const Diff_Line *B;                /**< Second sequence */
+  size_t sizeA;                      /**< Length of A */
+  size_t sizeB;                      /**< Length of B */
+  size_t doneA;                      /**< Lines of A already recorded when compose restarts */
+  size_t doneB;                      /**< Lines of B already recorded when compose restarts */
   size_t M;                          /**< M value */
   size_t N;                          /**< N value */
   size_t delta;                      /**< Delta */
   size_t offset;                     /**< offset */
-  long long *fp;                     /**< Pointer to elem */
+  editPath fp;                       /**< Furthest reaching y per diagonal, kept between composes */
   Diff_Ses ses;                      /**< Shortest edit scrit */
+  bool sesBuilt;                     /**< Flag to indicate ses was built from script */
+  editScript script;                 /**< Shortest edit script as runs of lines */
   editPath path;                     /**< Edit path */
   editPathCordinates pathCordinates; /**< Edit path coordinates */
+  editPathCordinates tracedPath;     /**< Coordinates of the path being recorded, kept between composes */
   bool swapped;                      /**< Flag to check if sequence are swapped */
   Diff_Compare cmp;                  /**< Comparison Functor */
+  diffModes diffMode;                /**< Way lines are compared */
+  diffAlgorithms diffAlgorithm;      /**< Algorithm used by compose */
+  editPath linearForward;            /**< Furthest forward x per diagonal in DIFF_LINEAR_SPACE */
+  editPath linearBackward;           /**< Furthest backward x per diagonal in DIFF_LINEAR_SPACE */
+  std::vector<uint64_t> hashA;       /**< Hashes of the lines of A in DIFF_HASHED mode */
+  std::vector<uint64_t> hashB;       /**< Hashes of the lines of B in DIFF_HASHED mode */
+
+  /**
+   * Fill hashA and hashB from A and B
+   */
+  void hashLines();
+
+  /**
+   * Append count lines of type to the edit script of this diff
+   */
+  void addEdit(int type, long long beforeIdx, long long afterIdx, long long count);
+
+  /**
+   * Compose the SES of A and B with the DIFF_LINEAR_SPACE algorithm
+   */
+  void composeLinear();
+
+  /**
+   * Find where a shortest edit path of lines [aFirst, aLast) of A and [bFirst, bLast) of B crosses its middle
+   * snake. The path goes through (aFirst + x, bFirst + y). Returns FALSE if the ranges have no common line
+   */
+  bool splitLinear(size_t aFirst, size_t aLast, size_t bFirst, size_t bLast, size_t &x, size_t &y);
+
+  /**
+   * Append count lines of type to script, with type and line indices x of A and y of B before any swap
+   */
+  void addLinearEdit(int type, size_t x, size_t y, size_t count);
+
+  /**
+   * Return TRUE if line x of A equals line y of B
+   */
+  bool sameLine(size_t x, size_t y) {
+    if (diffMode == DIFF_HASHED) {
+      return hashA[x] == hashB[y] && A[x].size == B[y].size && std::memcmp(A[x].data, B[y].data, A[x].size) == 0;
+    } // End check for DIFF_HASHED
+    return swapped ? cmp.impl(B[y], A[x]) : cmp.impl(A[x], B[y]);
+  }
+
   /**
    * Initialize
    */
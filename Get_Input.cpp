@@ -6,10 +6,14 @@
 #include "Get_Input.hpp"
 #include "Diff_Mapping.hpp"
 #include "Module.hpp"
+#include "Parallel_Util.hpp"
 namespace hydrogen_framework {
 bool Hydrogen::validateInputs(int c, char *files[]) {
   for (int index = 1; index < c; index++) {
     std::string file = files[index];
+    if (isOption(file)) {
+      continue;
+    } // End check for option
     struct stat buffer;
     int status = stat(file.c_str(), &buffer);
     if (status == -1) {
@@ -25,35 +29,123 @@ bool Hydrogen::validateInputs(int c, char *files[]) {
 } // End validateInputs
 
 bool Hydrogen::processInputs(int c, char *files[]) {
-  int countModules = 0;
+  /* Options apply to every module, wherever they appear */
+  for (int index = 1; index < c; ++index) {
+    if (isOption(files[index])) {
+      pushOption(files[index]);
+    } // End check for option
+  }   // End loop for options
+  bool reachableOnly = hasOption("reachable-only");
+  std::string reachableRoot = getOption("reachable-only").empty() ? "main" : getOption("reachable-only");
   /* Getting all the modules first */
+  std::vector<std::string> moduleFiles;
   int index = 1;
   for (; index < c; ++index) {
     std::string file = files[index];
+    if (isOption(file)) {
+      continue;
+    } // End check for option
     if (file == hydrogenDemarcation) {
       break;
     } // End check for hydrogenDemarcation
-    countModules++;
-    Module *module = new Module();
-    if (!module->setModule(countModules, file)) {
-      return false;
-    } // End check for module
-    hydrogenModules.push_back(module);
+    moduleFiles.push_back(file);
   } // End module loop
-  std::list<std::string> versionFiles;
-  for (++index; index < c; ++index) {
+  /* Every Module owns its LLVMContext, so modules are parsed and verified on their own threads */
+  std::vector<Module *> modules(moduleFiles.size(), NULL);
+  std::vector<char> moduleLoaded(moduleFiles.size(), 0);
+  std::vector<long long> loadTimes(moduleFiles.size(), 0);
+  /* Errors are collected per module and printed in module order once every worker is done */
+  std::vector<std::string> loadErrors(moduleFiles.size());
+  unsigned threads = hasOption("threads") ? getThreadCount() : moduleFiles.size();
+  parallelFor(moduleFiles.size(), threads, [&](std::size_t modIndex) {
+    auto loadStart = std::chrono::high_resolution_clock::now();
+    llvm::raw_string_ostream errors(loadErrors[modIndex]);
+    Module *module = new Module();
+    module->setLazyLoading(hasOption("lazy-load") || reachableOnly);
+    module->setTrustedInput(hasOption("trusted-input"));
+    if (module->setModule(modIndex + 1, moduleFiles[modIndex], errors)) {
+      moduleLoaded[modIndex] = 1;
+      if (reachableOnly) {
+        module->restrictToReachable(reachableRoot, errors);
+      } // End check for reachableOnly
+    }   // End check for setModule
+    modules[modIndex] = module;
+    auto loadStop = std::chrono::high_resolution_clock::now();
+    loadTimes[modIndex] = std::chrono::duration_cast<std::chrono::milliseconds>(loadStop - loadStart).count();
+    errors.flush();
+  });
+  bool allLoaded = true;
+  for (std::size_t modIndex = 0; modIndex < modules.size(); ++modIndex) {
+    allLoaded = allLoaded && moduleLoaded[modIndex];
+    std::cerr << loadErrors[modIndex];
+    if (moduleLoaded[modIndex]) {
+      std::cout << "Loaded " << moduleFiles[modIndex] << " in " << loadTimes[modIndex] << "ms\n";
+    } // End check for moduleLoaded
+  }   // End loop for modules
+  if (!allLoaded) {
+    for (auto module : modules) {
+      delete module;
+    } // End loop for modules
+    return false;
+  } // End check for allLoaded
+  hydrogenModules.insert(hydrogenModules.end(), modules.begin(), modules.end());
+  /* Files of each version follow their own demarcation, in module order */
+  for (int version = 1; version <= static_cast<int>(modules.size()) && index < c; ++version) {
+    std::list<std::string> versionFiles;
+    for (++index; index < c; ++index) {
       std::string file = files[index];
       /* Checking for proper loop exit */
       if (file == hydrogenDemarcation) {
         break;
       } // End check for hydrogenDemarcation
+      if (isOption(file)) {
+        continue;
+      } // End check for option
       versionFiles.push_back(file);
     } // End loop for versionFiles
     auto moduleIter = std::find_if(std::begin(hydrogenModules), std::end(hydrogenModules),
-                                   [=](Module *mod) { return (mod->getVersion() == 1); });
+                                   [=](Module *mod) { return (mod->getVersion() == version); });
     if (moduleIter != hydrogenModules.end()) {
       (*moduleIter)->setFiles(versionFiles);
-    } // End check for hydrogenDemarcation
-  return true;
+    } // End check for moduleIter
+  }   // End loop for versions
+  /* Every module needs its own group of files */
+  bool allFiles = true;
+  for (std::size_t modIndex = 0; modIndex < modules.size(); ++modIndex) {
+    if (modules[modIndex]->getFiles().empty()) {
+      std::cerr << "No source files given for " << moduleFiles[modIndex] << "\n"
+                << "Please give one " << hydrogenDemarcation << " group of files for every module, in module order\n";
+      allFiles = false;
+    } // End check for files
+  }   // End loop for modules
+  return allFiles;
 } // End processInputs
+
+void Hydrogen::pushOption(std::string arg) {
+  std::size_t valuePos = arg.find('=');
+  if (valuePos == std::string::npos) {
+    hydrogenOptions[arg.substr(2)] = "";
+  } else {
+    hydrogenOptions[arg.substr(2, valuePos - 2)] = arg.substr(valuePos + 1);
+  } // End check for option value
+} // End pushOption
+
+std::string Hydrogen::getOption(std::string name) {
+  auto option = hydrogenOptions.find(name);
+  if (option != hydrogenOptions.end()) {
+    return option->second;
+  } // End check for option
+  return "";
+} // End getOption
+
+unsigned Hydrogen::getThreadCount() {
+  if (!hasOption("threads")) {
+    return 1;
+  } // End check for threads option
+  int threads = std::atoi(getOption("threads").c_str());
+  if (threads <= 0) {
+    return getDefaultThreadCount();
+  } // End check for thread count value
+  return static_cast<unsigned>(threads);
+} // End getThreadCount
 } // namespace hydrogen_framework
\ No newline at end of file
@@ -9,8 +9,11 @@
 #include <algorithm>
 #include <boost/algorithm/string.hpp>
 #include <boost/filesystem.hpp>
+#include <chrono>
 #include <fstream>
+#include <map>
 #include <sys/stat.h>
+#include <vector>
 namespace hydrogen_framework {
 /* Forward declaration */
 class Module;
@@ -39,7 +42,8 @@ public:
 
   /**
    * Process provided inputs.
-   * Returns FALSE if any of the Module cannot be parsed properly.
+   * Modules are loaded on one thread each, or on --threads workers, and their load times are printed in order
+   * Returns FALSE if any of the Module cannot be parsed properly, or has no group of files after a demarcation.
    */
   bool processInputs(int c, char *files[]);
 
@@ -48,9 +52,37 @@ public:
    */
   std::list<Module *> getModules() { return hydrogenModules; }
 
+  /**
+   * Return TRUE if the argument is an option of the form --name or --name=value
+   */
+  bool isOption(std::string arg) { return arg.size() > 2 && arg.compare(0, 2, "--") == 0; }
+
+  /**
+   * Return TRUE if the option was given on the command line
+   */
+  bool hasOption(std::string name) { return hydrogenOptions.find(name) != hydrogenOptions.end(); }
+
+  /**
+   * Return the value of an option
+   * Returns empty string if the option was not given or was given without a value
+   */
+  std::string getOption(std::string name);
+
+  /**
+   * Return the number of worker threads requested through --threads
+   * Returns 1 if the option was not given and the hardware thread count if it was given without a value
+   */
+  unsigned getThreadCount();
+
 private:
-  std::string hydrogenDemarcation;     /**< Setting demarcation string for inputs */
-  std::list<Module *> hydrogenModules; /**< Container for storing LLVM Modules */
-};                                     // End hydrogen class
+  /**
+   * Record an option of the form --name or --name=value
+   */
+  void pushOption(std::string arg);
+
+  std::string hydrogenDemarcation;                    /**< Setting demarcation string for inputs */
+  std::list<Module *> hydrogenModules;                /**< Container for storing LLVM Modules */
+  std::map<std::string, std::string> hydrogenOptions; /**< Container for --name=value options */
+};                                                    // End hydrogen class
 } // namespace hydrogen_framework
 #endif
@@ -4,16 +4,184 @@
  * Implementing Graph.hpp
  */
 #include "Graph.hpp"
+#include "Call_Resolver.hpp"
 #include "Graph_Edge.hpp"
 #include "Graph_Function.hpp"
 #include "Graph_Instruction.hpp"
 #include "Graph_Line.hpp"
+#include "Graph_Export.hpp"
+#include "Parallel_Util.hpp"
+#include <llvm/IR/InlineAsm.h>
+#include <set>
 namespace hydrogen_framework {
 void Graph::pushGraphFunction(Graph_Function *func) {
   func->setGraph(this);
+  unsigned order = functionOrder.size();
+  functionOrder[func] = order;
   graphFunctions.push_back(func);
+  for (auto line : func->getFunctionLines()) {
+    indexGraphLine(line);
+  } // End loop for line
 } // End pushGraphFunction
 
+unsigned Graph::getFileID(std::string fileName) {
+  auto findFile = graphFileIDs.find(fileName);
+  if (findFile != graphFileIDs.end()) {
+    return findFile->second;
+  } // End check for known file
+  unsigned fileID = graphFileIDs.size();
+  graphFileIDs.insert(std::make_pair(fileName, fileID));
+  return fileID;
+} // End getFileID
+
+void Graph::indexGraphLine(Graph_Line *line) {
+  for (auto number : line->getLineNumbers()) {
+    indexGraphLine(line, number.first, number.second);
+  } // End loop for number
+} // End indexGraphLine
+
+void Graph::indexGraphLine(Graph_Line *line, unsigned Version, unsigned lineNumber) {
+  unsigned long long key = getFileID(line->getGraphFunction()->getFunctionFile());
+  key = (key << 32) | lineNumber;
+  lineIndex[Version][key].push_back(line);
+} // End indexGraphLine
+
+const std::list<Graph_Line *> *Graph::findIndexedLines(unsigned Version, std::string fileName, unsigned lineNumber) {
+  auto findVersion = lineIndex.find(Version);
+  auto findFile = graphFileIDs.find(fileName);
+  if (findVersion == lineIndex.end() || findFile == graphFileIDs.end()) {
+    return NULL;
+  } // End check for version and file
+  unsigned long long key = findFile->second;
+  auto findLines = findVersion->second.find((key << 32) | lineNumber);
+  if (findLines == findVersion->second.end()) {
+    return NULL;
+  } // End check for lines
+  return &findLines->second;
+} // End findIndexedLines
+
+std::list<Graph_Line *> Graph::getFirstFunctionLines(const std::list<Graph_Line *> &indexedLines,
+                                                     const std::string *functionName) {
+  /* Only the lines of the earliest function are returned, like a walk over graphFunctions would */
+  Graph_Function *first = NULL;
+  for (auto line : indexedLines) {
+    Graph_Function *func = line->getGraphFunction();
+    if (functionName && func->getFunctionName() != *functionName) {
+      continue;
+    } // End check for functionName
+    if (!first || functionOrder.at(func) < functionOrder.at(first)) {
+      first = func;
+    } // End check for earlier function
+  }   // End loop for line
+  std::list<Graph_Line *> graphLines;
+  for (auto line : indexedLines) {
+    if (line->getGraphFunction() == first) {
+      graphLines.push_back(line);
+    } // End check for first function
+  }   // End loop for line
+  return graphLines;
+} // End getFirstFunctionLines
+
+std::list<Graph_Line *> Graph::getIndexedLines(unsigned Version, std::string fileName, unsigned lineNumber) {
+  const std::list<Graph_Line *> *indexedLines = findIndexedLines(Version, fileName, lineNumber);
+  if (!indexedLines) {
+    return std::list<Graph_Line *>();
+  } // End check for indexedLines
+  return getFirstFunctionLines(*indexedLines, NULL);
+} // End getIndexedLines
+
+std::list<Graph_Line *> Graph::getIndexedLines(unsigned Version, std::string fileName, unsigned lineNumber,
+                                               std::string functionName) {
+  const std::list<Graph_Line *> *indexedLines = findIndexedLines(Version, fileName, lineNumber);
+  if (!indexedLines) {
+    return std::list<Graph_Line *>();
+  } // End check for indexedLines
+  return getFirstFunctionLines(*indexedLines, &functionName);
+} // End getIndexedLines
+
+void Graph::mergeGraph(Graph *part) {
+  unsigned offset = graphID;
+  for (auto func : part->graphFunctions) {
+    func->setFunctionID(func->getFunctionID() + offset);
+    for (auto line : func->getFunctionLines()) {
+      for (auto inst : line->getLineInstructions()) {
+        inst->setInstructionID(inst->getInstructionID() + offset);
+      } // End loop for inst
+    }   // End loop for line
+    pushGraphFunction(func);
+  } // End loop for func
+  graphEdges.splice(graphEdges.end(), part->graphEdges);
+  part->graphFunctions.clear();
+  part->functionOrder.clear();
+  part->lineIndex.clear();
+  graphID += part->graphID;
+  part->graphID = 0;
+} // End mergeGraph
+
+void Graph::releaseGraph() {
+  /* Edges are shared by the instructions at both ends, so they are collected once and deleted last */
+  std::set<Graph_Edge *> edges(graphEdges.begin(), graphEdges.end());
+  for (auto &expansion : graphExpansions) {
+    for (auto inst : expansion.second) {
+      if (inst == expansion.first) {
+        continue;
+      } // End check for the node itself
+      for (auto edge : inst->getInstructionEdges()) {
+        edges.insert(edge);
+      } // End loop for expanded edges
+      delete inst;
+    } // End loop for expanded nodes
+  }   // End loop for graphExpansions
+  graphExpansions.clear();
+  for (auto func : graphFunctions) {
+    for (auto line : func->getFunctionLines()) {
+      for (auto inst : line->getLineInstructions()) {
+        delete inst;
+      } // End loop for inst
+      delete line;
+    } // End loop for line
+    delete func;
+  } // End loop for func
+  graphFunctions.clear();
+  functionOrder.clear();
+  lineIndex.clear();
+  graphFileIDs.clear();
+  for (auto edge : edges) {
+    delete edge;
+  } // End loop for edges
+  graphEdges.clear();
+} // End releaseGraph
+
+std::list<Graph_Instruction *> Graph::expandInstruction(Graph_Instruction *node) {
+  std::list<Graph_Instruction *> expanded;
+  if (node->getInstructionCount() <= 1) {
+    expanded.push_back(node);
+    return expanded;
+  } // End check for instruction level node
+  auto findExpansion = graphExpansions.find(node);
+  if (findExpansion != graphExpansions.end()) {
+    return findExpansion->second;
+  } // End check for cached expansion
+  for (auto I : node->getInstructionRange()) {
+    /* Labels are printed again since a single instruction label can span several rows */
+    std::string instLabel;
+    llvm::raw_string_ostream rInstLabel(instLabel);
+    I->print(rInstLabel);
+    Graph_Instruction *inst = new Graph_Instruction();
+    inst->setInstructionLabel(rInstLabel.str());
+    inst->setInstructionPtr(I);
+    inst->setGraphLine(node->getGraphLine());
+    if (!expanded.empty()) {
+      Graph_Edge *seqEdge = new Graph_Edge(expanded.back(), inst, Graph_Edge::SEQUENTIAL, graphVersion);
+      expanded.back()->pushEdgeInstruction(seqEdge);
+      inst->pushEdgeInstruction(seqEdge);
+    } // End check for first instruction
+    expanded.push_back(inst);
+  } // End loop for range
+  graphExpansions.insert(std::make_pair(node, expanded));
+  return expanded;
+} // End expandInstruction
+
 void Graph::addEdge(Graph_Instruction *from, Graph_Instruction *to, Graph_Edge *edge) {
   from->pushEdgeInstruction(edge);
   to->pushEdgeInstruction(edge);
@@ -24,7 +192,7 @@ void Graph::addSeqEdges(Graph_Line *line) {
   std::list<Graph_Instruction *> instructions = line->getLineInstructions();
   for (auto inst = instructions.begin(), instEnd = instructions.end(); inst != instEnd; ++inst) {
     /* Double check to make sure it is not Br */
-    llvm::Instruction *llvmInst = (*inst)->getInstructionPtr();
+    llvm::Instruction *llvmInst = (*inst)->getLastInstructionPtr();
     if (llvmInst) {
       if (llvmInst->getOpcode() == llvm::Instruction::Br) {
         continue;
@@ -82,43 +250,65 @@ Graph_Instruction *Graph::findVirtualExit(std::string funcName) {
 } // End findVirtualExit
 
 void Graph::addBranchEdges() {
-  for (auto func : graphFunctions) {
-    std::list<Graph_Line *> lines = func->getFunctionLines();
-    for (auto line = lines.begin(); line != lines.end(); ++line) {
-      std::list<Graph_Instruction *> instructions = (*line)->getLineInstructions();
-      for (auto inst = instructions.begin(); inst != instructions.end(); ++inst) {
-        llvm::Instruction *I = (*inst)->getInstructionPtr();
-        if (I) {
-          /* Adding edges for BB with multiple successors */
-          if (I->isTerminator()) {
-            unsigned int noSucc = I->getNumSuccessors();
-            for (unsigned int iterSucc = 0; iterSucc < noSucc; ++iterSucc) {
-              llvm::Instruction *iSucc = llvm::dyn_cast<llvm::Instruction>(I->getSuccessor(iterSucc)->begin());
-              Graph_Instruction *iSuccInst = findMatchedInstruction(iSucc);
-              if (iSucc) {
-                Graph_Edge *branchEdge = new Graph_Edge(*inst, iSuccInst, Graph_Edge::BRANCH, graphVersion);
-                addEdge(*inst, iSuccInst, branchEdge);
-              } else {
-                std::cerr << "No matching Graph_Instruction found for edge from " << (*inst)->getInstructionLabel()
-                          << "\n";
-              } // End check for iSucc
-            }   // End loop for iterSucc
-          } else if ((*inst)->getInstructionID() == instructions.back()->getInstructionID()) {
-            /* Adding Unique successors */
-            auto nextLine = std::next(line);
-            if (nextLine != lines.end()) {
-              std::list<Graph_Instruction *> nextInstructions = (*nextLine)->getLineInstructions();
-              auto nextI = nextInstructions.begin();
-              if (nextI != nextInstructions.end()) {
-                Graph_Edge *seqEdge = new Graph_Edge(*inst, *nextI, Graph_Edge::SEQUENTIAL, graphVersion);
-                addEdge(*inst, *nextI, seqEdge);
-              } // End check for nextI
-            }   // End check for nextLine
-          }     // End check for TerminatorInst
-        }       // End check for I
-      }         // End loop for inst
-    }           // End llop for line
-  }             // End loop for func
+  std::vector<Graph_Function *> functions(graphFunctions.begin(), graphFunctions.end());
+  std::vector<std::list<Graph_Edge *>> branchEdges(functions.size());
+  parallelFor(functions.size(), graphThreads,
+              [&](std::size_t index) { addBranchEdges(functions[index], branchEdges[index]); });
+  for (auto &edges : branchEdges) {
+    graphEdges.splice(graphEdges.end(), edges);
+  } // End loop for branchEdges
+} // End addBranchEdges
+
+void Graph::addBranchEdges(Graph_Function *func, std::list<Graph_Edge *> &branchEdges) {
+  std::list<Graph_Line *> lines = func->getFunctionLines();
+  /* Successors of a terminator always start a BasicBlock of the same function */
+  std::map<llvm::Instruction *, Graph_Instruction *> funcInstructions;
+  for (auto line : lines) {
+    for (auto inst : line->getLineInstructions()) {
+      if (inst->getInstructionPtr()) {
+        funcInstructions.insert(std::make_pair(inst->getInstructionPtr(), inst));
+      } // End check for instructionPtr
+    }   // End loop for inst
+  }     // End loop for line
+  for (auto line = lines.begin(); line != lines.end(); ++line) {
+    std::list<Graph_Instruction *> instructions = (*line)->getLineInstructions();
+    for (auto inst = instructions.begin(); inst != instructions.end(); ++inst) {
+      llvm::Instruction *I = (*inst)->getLastInstructionPtr();
+      if (I) {
+        /* Adding edges for BB with multiple successors */
+        if (I->isTerminator()) {
+          unsigned int noSucc = I->getNumSuccessors();
+          for (unsigned int iterSucc = 0; iterSucc < noSucc; ++iterSucc) {
+            llvm::Instruction *iSucc = llvm::dyn_cast<llvm::Instruction>(I->getSuccessor(iterSucc)->begin());
+            auto findSucc = funcInstructions.find(iSucc);
+            if (findSucc != funcInstructions.end()) {
+              Graph_Instruction *iSuccInst = findSucc->second;
+              Graph_Edge *branchEdge = new Graph_Edge(*inst, iSuccInst, Graph_Edge::BRANCH, graphVersion);
+              (*inst)->pushEdgeInstruction(branchEdge);
+              iSuccInst->pushEdgeInstruction(branchEdge);
+              branchEdges.push_back(branchEdge);
+            } else {
+              std::cerr << "No matching Graph_Instruction found for edge from " << (*inst)->getInstructionLabel()
+                        << "\n";
+            } // End check for iSucc
+          }   // End loop for iterSucc
+        } else if ((*inst)->getInstructionID() == instructions.back()->getInstructionID()) {
+          /* Adding Unique successors */
+          auto nextLine = std::next(line);
+          if (nextLine != lines.end()) {
+            std::list<Graph_Instruction *> nextInstructions = (*nextLine)->getLineInstructions();
+            auto nextI = nextInstructions.begin();
+            if (nextI != nextInstructions.end()) {
+              Graph_Edge *seqEdge = new Graph_Edge(*inst, *nextI, Graph_Edge::SEQUENTIAL, graphVersion);
+              (*inst)->pushEdgeInstruction(seqEdge);
+              (*nextI)->pushEdgeInstruction(seqEdge);
+              branchEdges.push_back(seqEdge);
+            } // End check for nextI
+          }   // End check for nextLine
+        }     // End check for TerminatorInst
+      }       // End check for I
+    }         // End loop for inst
+  }           // End llop for line
 } // End addBranchEdges
 
 void Graph::addFunctionCallEdges() {
@@ -139,61 +329,134 @@ void Graph::addFunctionCallEdges() {
   /* Get the whitelisted function names and merge with funcNotFoud */
   std::list<std::string> whiteListedFunc = Graph::getWhiteList();
   funcNotFoud.insert(funcNotFoud.end(), whiteListedFunc.begin(), whiteListedFunc.end());
+  /* Resolve callees per function, then add the edges in function order */
+  std::vector<Graph_Function *> functions(graphFunctions.begin(), graphFunctions.end());
+  std::vector<std::list<Call_Resolution>> resolutions(functions.size());
+  Call_Resolver *resolver = NULL;
+  llvm::Module *graphModule = getGraphModule();
+  if (graphIndirectCalls != INDIRECT_EXTERNAL && graphModule) {
+    resolver = new Call_Resolver(graphModule, graphIndirectCalls == INDIRECT_POINTS_TO);
+  } // End check for graphIndirectCalls
+  parallelFor(functions.size(), graphThreads,
+              [&](std::size_t index) { resolveFunctionCalls(functions[index], resolver, resolutions[index]); });
+  delete resolver;
+  for (auto &calls : resolutions) {
+    for (auto &call : calls) {
+      Graph_Instruction *inst = call.callSite;
+      if (call.calleeKind == EXTERNAL_CALLEE) {
+        /* Call Extern */
+        Graph_Edge *callEdge = new Graph_Edge(inst, externalNode, Graph_Edge::EXTERNAL_CALL, graphVersion);
+        addEdge(inst, externalNode, callEdge);
+      } else if (call.calleeKind == NAMED_CALLEE) {
+        /* Add Edge based on function name */
+        bool noEntry = false;
+        bool noExit = false;
+        std::string funcName = call.calleeName;
+        /* Call site to Entry */
+        Graph_Instruction *virtualEntry = call.virtualEntry;
+        if (virtualEntry) {
+          Graph_Edge *callEdge = new Graph_Edge(inst, virtualEntry, Graph_Edge::CALL, graphVersion);
+          addEdge(inst, virtualEntry, callEdge);
+        } else {
+          noEntry = true;
+        } // End check for virtualEntry
+        /* Exit to Call site */
+        Graph_Instruction *virtualExit = call.virtualExit;
+        if (virtualExit) {
+          Graph_Edge *callEdge = new Graph_Edge(virtualExit, inst, Graph_Edge::CALL, graphVersion);
+          addEdge(virtualExit, inst, callEdge);
+        } else {
+          noExit = true;
+        } // End check for virtualExit
+        auto findFunc = std::find_if(std::begin(funcNotFoud), std::end(funcNotFoud),
+                                     [=](std::string name) { return name == funcName; });
+        if (findFunc == funcNotFoud.end()) {
+          if (noEntry && noExit) {
+            funcNotFoud.push_back(funcName);
+            std::cerr << "Call edges not formed for " << funcName << "\n";
+          } else if (noEntry) {
+            std::cerr << "No Virtual Entry found for " << funcName << "\n";
+          } else if (noExit) {
+            std::cerr << "No Virtual Exit found for " << funcName << "\n";
+          } // End check for noEntry & noExit combinations
+        }   // End check for findFunc
+      } else {
+        std::cerr << "Unknown function call from Instruction " << inst->getInstructionLabel() << "\n";
+      } // End check for calleeKind
+    }   // End loop for call
+  }     // End loop for resolutions
+} // End addFunctionCallEdges
+
+void Graph::resolveFunctionCalls(Graph_Function *func, Call_Resolver *resolver, std::list<Call_Resolution> &calls) {
+  for (auto line : func->getFunctionLines()) {
+    for (auto inst : line->getLineInstructions()) {
+      llvm::Instruction *I = inst->getLastInstructionPtr();
+      if (I) {
+        if (auto callSite = llvm::CallSite(I)) {
+          const llvm::Function *Callee = callSite.getCalledFunction();
+          Call_Resolution call;
+          call.callSite = inst;
+          call.virtualEntry = NULL;
+          call.virtualExit = NULL;
+          if (!Callee && resolver && !llvm::isa<llvm::InlineAsm>(callSite.getCalledValue())) {
+            /* Indirect call. Defined targets get their own call edges, the rest go to the External_Node */
+            bool externalTarget = false;
+            std::vector<const llvm::Function *> targets = resolver->resolveCallTargets(callSite);
+            for (auto target : targets) {
+              if (target->isDeclaration()) {
+                externalTarget = true;
+                continue;
+              } // End check for declaration
+              Call_Resolution targetCall = call;
+              if (!target->getName().empty()) {
+                targetCall.calleeKind = NAMED_CALLEE;
+                targetCall.calleeName = target->getName().str();
+                targetCall.virtualEntry = findVirtualEntry(targetCall.calleeName);
+                targetCall.virtualExit = findVirtualExit(targetCall.calleeName);
+              } else {
+                targetCall.calleeKind = UNNAMED_CALLEE;
+              } // End check for target name
+              calls.push_back(targetCall);
+            } // End loop for targets
+            if (targets.empty() || externalTarget) {
+              call.calleeKind = EXTERNAL_CALLEE;
+              calls.push_back(call);
+            } // End check for external targets
+            continue;
+          } else if (!Callee || !llvm::Intrinsic::isLeaf(Callee->getIntrinsicID())) {
+            call.calleeKind = EXTERNAL_CALLEE;
+          } else if (!Callee->isIntrinsic()) {
+            if (!Callee->getName().empty()) {
+              call.calleeKind = NAMED_CALLEE;
+              call.calleeName = Callee->getName().str();
+              call.virtualEntry = findVirtualEntry(call.calleeName);
+              call.virtualExit = findVirtualExit(call.calleeName);
+            } else {
+              call.calleeKind = UNNAMED_CALLEE;
+            } // End check for Callee name
+          } else {
+            /* Leaf intrinsics do not get call edges */
+            continue;
+          } // End check for Callee Intrinsic
+          calls.push_back(call);
+        } // End check for callSite
+      }   // End check for I
+    }     // End loop for inst
+  }       // End loop for line
+} // End resolveFunctionCalls
+
+llvm::Module *Graph::getGraphModule() {
   for (auto func : graphFunctions) {
     for (auto line : func->getFunctionLines()) {
       for (auto inst : line->getLineInstructions()) {
-        llvm::Instruction *I = inst->getInstructionPtr();
-        if (I) {
-          if (auto callSite = llvm::CallSite(I)) {
-            const llvm::Function *Callee = callSite.getCalledFunction();
-            if (!Callee || !llvm::Intrinsic::isLeaf(Callee->getIntrinsicID())) {
-              /* Call Extern */
-              Graph_Edge *callEdge = new Graph_Edge(inst, externalNode, Graph_Edge::EXTERNAL_CALL, graphVersion);
-              addEdge(inst, externalNode, callEdge);
-            } else if (!Callee->isIntrinsic()) {
-              /* Add Edge based on function name */
-              bool noEntry = false;
-              bool noExit = false;
-              if (!Callee->getName().empty()) {
-                std::string funcName = Callee->getName();
-                /* Call site to Entry */
-                Graph_Instruction *virtualEntry = findVirtualEntry(funcName);
-                if (virtualEntry) {
-                  Graph_Edge *callEdge = new Graph_Edge(inst, virtualEntry, Graph_Edge::CALL, graphVersion);
-                  addEdge(inst, virtualEntry, callEdge);
-                } else {
-                  noEntry = true;
-                } // End check for virtualEntry
-                /* Exit to Call site */
-                Graph_Instruction *virtualExit = findVirtualExit(funcName);
-                if (virtualExit) {
-                  Graph_Edge *callEdge = new Graph_Edge(virtualExit, inst, Graph_Edge::CALL, graphVersion);
-                  addEdge(virtualExit, inst, callEdge);
-                } else {
-                  noExit = true;
-                } // End check for virtualExit
-                auto findFunc = std::find_if(std::begin(funcNotFoud), std::end(funcNotFoud),
-                                             [=](std::string name) { return name == funcName; });
-                if (findFunc == funcNotFoud.end()) {
-                  if (noEntry && noExit) {
-                    funcNotFoud.push_back(funcName);
-                    std::cerr << "Call edges not formed for " << funcName << "\n";
-                  } else if (noEntry) {
-                    std::cerr << "No Virtual Entry found for " << funcName << "\n";
-                  } else if (noExit) {
-                    std::cerr << "No Virtual Exit found for " << funcName << "\n";
-                  } // End check for noEntry & noExit combinations
-                }   // End check for findFunc
-              } else {
-                std::cerr << "Unknown function call from Instruction " << inst->getInstructionLabel() << "\n";
-              } // End check for Callee name
-            }   // End check for Callee Intrinsic
-          }     // End check for callSite
-        }       // End check for I
-      }         // End loop for inst
-    }           // End loop for line
-  }             // End loop for func
-} // End addFunctionCallEdges
+        if (inst->getInstructionPtr()) {
+          return inst->getInstructionPtr()->getModule();
+        } // End check for Instruction Ptr
+      }   // End loop for inst
+    }     // End loop for line
+  }       // End loop for func
+  return NULL;
+} // End getGraphModule
 
 void Graph::addVirtualNodes(Graph_Function *func) {
   std::string funcName = func->getFunctionName();
@@ -224,73 +487,14 @@ void Graph::addVirtualNodes(Graph_Function *func) {
 } // End addVirtualNodes
 
 void Graph::printGraph(std::string graphName) {
-  std::ofstream gFile(graphName + ".dot", std::ios::trunc);
-  if (!gFile.is_open()) {
-    std::cerr << "Unable to open file for printing the output\n";
-    return;
-  } // End check for gFile
-  /* Initialize graph */
-  gFile << "digraph \"MVICFG\" {\n";
-  gFile << "\tlabel=\"" << graphName << "\";\n";
-  /* Generating Nodes */
-  gFile << "/* Generating Nodes */\n";
-  for (auto func : graphFunctions) {
-    gFile << "\tsubgraph cluster_" << func->getFunctionID() << " {\n";
-    gFile << "\t\tlabel=\"" << func->getFunctionName() << "\";\n";
-    for (auto line : func->getFunctionLines()) {
-      for (auto inst : line->getLineInstructions()) {
-        std::string outputString = std::regex_replace(inst->getInstructionLabel(), std::regex("\""), "\\\"");
-        gFile << "\t\t\"" << inst->getInstructionID() << "\" [label=\"" << line->getLineNumber(graphVersion)
-              << "::" << outputString << "\"];\n";
-      } // End loop for inst
-    }   // End loop for line
-    gFile << "\t}\n";
-  } // End loop for func
-  /* Generating Edges*/
-  gFile << "\n/* Generating Edges */\n";
-  for (auto edge : graphEdges) {
-    std::string outputString = "\t\t\"" + std::to_string(edge->getEdgeFrom()->getInstructionID()) + "\" -> \"" +
-                               std::to_string(edge->getEdgeTo()->getInstructionID());
-    switch (edge->getEdgeType()) {
-    case Graph_Edge::SEQUENTIAL:
-      outputString += "\" [arrowhead = normal, penwidth = 1.0, color = black, label=\"" +
-                      edge->getPrintableEdgeVersions() + "\"];\n";
-      break;
-    case Graph_Edge::BRANCH:
-      outputString += "\" [arrowhead = dot, penwidth = 1.0, color = black, label=\"" +
-                      edge->getPrintableEdgeVersions() + "::Branch\"];\n";
-      break;
-    case Graph_Edge::VIRTUAL:
-      outputString += "\" [arrowhead = normal, penwidth = 1.0, color = pink, label=\"" +
-                      edge->getPrintableEdgeVersions() + "::Virtual\"];\n";
-      break;
-    case Graph_Edge::CALL:
-      outputString += "\" [arrowhead = odot, penwidth = 1.0, color = blue, label=\"" +
-                      edge->getPrintableEdgeVersions() + "::Call\"];\n";
-      break;
-    case Graph_Edge::EXTERNAL_CALL:
-      outputString += "\" [arrowhead = odot, penwidth = 1.0, color = yellow, label=\"" +
-                      edge->getPrintableEdgeVersions() + "::External_Call\"];\n";
-      break;
-    case Graph_Edge::MVICFG_ADD:
-      outputString += "\" [arrowhead = normal, penwidth = 1.0, color = green, label=\"" +
-                      edge->getPrintableEdgeVersions() + "::Add\"];\n";
-      break;
-    case Graph_Edge::MVICFG_DEL:
-      outputString += "\" [arrowhead = normal, penwidth = 1.0, color = red, label=\"" +
-                      edge->getPrintableEdgeVersions() + "::Del\"];\n";
-      break;
-    case Graph_Edge::ANY:
-      std::cerr << "Should not have ANY as edgeType\n";
-      outputString += "\" [arrowhead = normal, penwidth = 2.0, color = red, label=\"" +
-                      edge->getPrintableEdgeVersions() + "::ANY\"];\n";
-      break;
-    } // End switch for edge
-    gFile << outputString;
-  } // End loop for edge
-  /* Finalizing graph */
-  gFile << "}\n";
-  gFile.close();
+  Export_Options options;
+  options.exportThreads = graphThreads;
+  printGraph(graphName, options);
+} // End printGraph
+
+void Graph::printGraph(std::string graphName, const Export_Options &options) {
+  Graph_Export exporter(this, options);
+  exporter.writeGraph(graphName);
 } // End printGraph
 
 void getLocationInfo(llvm::Instruction &I, unsigned int &DILocLine, std::string &DIFile) {
@@ -337,6 +541,28 @@ void getLocationInfo(llvm::Instruction &I, unsigned int &DILocLine, std::string
   }   // End check for getDebugLoc
 } // End getLocationInfo
 
+std::vector<llvm::DILocation *> getBlockLocationTable(llvm::BasicBlock &BB) {
+  std::vector<llvm::DILocation *> locations;
+  /* Forward sweep: own location or the closest earlier one */
+  llvm::DILocation *lastLoc = NULL;
+  for (llvm::Instruction &I : BB) {
+    if (llvm::DILocation *DILoc = I.getDebugLoc()) {
+      lastLoc = DILoc;
+    } // End check for getDebugLoc
+    locations.push_back(lastLoc);
+  } // End loop for forward sweep
+  /* Backward sweep: closest later location for the leading instructions that are still unresolved */
+  llvm::DILocation *nextLoc = NULL;
+  for (std::size_t index = locations.size(); index > 0; --index) {
+    if (locations[index - 1]) {
+      nextLoc = locations[index - 1];
+    } else {
+      locations[index - 1] = nextLoc;
+    } // End check for resolved location
+  }   // End loop for backward sweep
+  return locations;
+} // End getBlockLocationTable
+
 bool Graph::isVirtualNodeLineNumber(unsigned lineNumber) {
   if (lineNumber == graphEntryID || lineNumber == graphExitID) {
     return true;
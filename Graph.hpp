@@ -14,9 +14,14 @@
 #include <llvm/IR/DebugInfoMetadata.h>
 #include <llvm/IR/InstrTypes.h>
 #include <llvm/IR/Intrinsics.h>
+#include <map>
 #include <regex>
+#include <unordered_map>
+#include <vector>
 namespace hydrogen_framework {
 /* Forward declaration */
+class Call_Resolver;
+struct Export_Options;
 class Graph_Edge;
 class Graph_Function;
 class Graph_Instruction;
@@ -33,7 +38,8 @@ public:
    */
   Graph(unsigned ver)
       : graphID(0), graphVersion(ver), graphEntryID(std::numeric_limits<unsigned int>::max() - 1),
-        graphExitID(std::numeric_limits<unsigned int>::max() - 2) {
+        graphExitID(std::numeric_limits<unsigned int>::max() - 2), graphThreads(1),
+        graphGranularity(INSTRUCTION_LEVEL), graphIndirectCalls(INDIRECT_EXTERNAL) {
     whiteList.push_back("__isoc99_scanf");
     whiteList.push_back("printf");
     whiteList.push_back("malloc");
@@ -73,13 +79,42 @@ public:
   ~Graph() {
     graphEdges.clear();
     graphFunctions.clear();
+    graphExpansions.clear();
+    lineIndex.clear();
   }
 
+  /**
+   * Enumeration for what a Graph_Instruction node stands for
+   * INSTRUCTION_LEVEL: one node per LLVM instruction
+   * BLOCK_LEVEL: one node per straight-line run of LLVM instructions that share a BasicBlock and a Graph_Line.
+   * Runs also end after calls, so call edges leave from the last instruction of a node
+   */
+  enum graphGranularities { INSTRUCTION_LEVEL, BLOCK_LEVEL };
+
+  /**
+   * Enumeration for how indirect calls are resolved
+   * INDIRECT_EXTERNAL: every indirect call goes to the External_Node
+   * INDIRECT_SIGNATURE: indirect calls go to every address-taken function of the same signature
+   * INDIRECT_POINTS_TO: like INDIRECT_SIGNATURE, but the called pointer is first traced to the functions stored in it
+   * Only calls without any target defined in the module still go to the External_Node
+   */
+  enum indirectCallModes { INDIRECT_EXTERNAL, INDIRECT_SIGNATURE, INDIRECT_POINTS_TO };
+
   /**
    * Get next ID
    */
   unsigned getNextID() { return ++graphID; }
 
+  /**
+   * Return the last ID handed out
+   */
+  unsigned getCurrentID() { return graphID; }
+
+  /**
+   * Set the last ID handed out. Used when restoring a Graph whose IDs were assigned elsewhere
+   */
+  void setCurrentID(unsigned id) { graphID = id; }
+
   /**
    * Return graphVersion
    */
@@ -90,16 +125,91 @@ public:
    */
   void setGraphVersion(unsigned ver) { graphVersion = ver; }
 
+  /**
+   * Return graphThreads
+   */
+  unsigned getGraphThreadCount() { return graphThreads; }
+
+  /**
+   * Set graphThreads. Values above 1 build and link function subgraphs on worker threads
+   */
+  void setGraphThreadCount(unsigned threads) { graphThreads = threads > 0 ? threads : 1; }
+
+  /**
+   * Return graphGranularity
+   */
+  graphGranularities getGraphGranularity() { return graphGranularity; }
+
+  /**
+   * Set graphGranularity. Must be set before the graph is built
+   * BLOCK_LEVEL graphs are meant for analysis and export. MVICFG construction expects INSTRUCTION_LEVEL
+   */
+  void setGraphGranularity(graphGranularities granularity) { graphGranularity = granularity; }
+
+  /**
+   * Return graphIndirectCalls
+   */
+  indirectCallModes getGraphIndirectCalls() { return graphIndirectCalls; }
+
+  /**
+   * Set graphIndirectCalls. Must be set before addFunctionCallEdges
+   */
+  void setGraphIndirectCalls(indirectCallModes mode) { graphIndirectCalls = mode; }
+
+  /**
+   * Expand a node into one Graph_Instruction per LLVM instruction it covers
+   * Returns the node itself for instruction level nodes. Expanded nodes are created on first request, cached,
+   * and linked to each other by SEQUENTIAL edges that are not part of graphEdges.
+   * They share the Graph_Line of the node but are not part of it and have ID zero
+   */
+  std::list<Graph_Instruction *> expandInstruction(Graph_Instruction *node);
+
+  /**
+   * Move the functions and edges of a partial Graph built on a worker into this Graph
+   * IDs of the partial Graph are shifted past the IDs already handed out, so merging partial Graphs
+   * in function order gives the same IDs as building them one after another
+   */
+  void mergeGraph(Graph *part);
+
+  /**
+   * Delete every function, line, instruction and edge of the Graph, including expanded nodes
+   * The Graph is empty afterwards. Nothing outside the Graph may still point into it
+   */
+  void releaseGraph();
+
   /**
    * Push Graph_Edge into graphEdges
    */
   void pushGraphEdges(Graph_Edge *edge) { graphEdges.push_back(edge); }
 
   /**
-   * Push Graph_Function into graphFunctions
+   * Push Graph_Function into graphFunctions and add its lines to the line index
+   * The function file must be set before the function is pushed
    */
   void pushGraphFunction(Graph_Function *func);
 
+  /**
+   * Add every line number of line to the line index. Called when line joins a function of this Graph
+   */
+  void indexGraphLine(Graph_Line *line);
+
+  /**
+   * Add the number of line in Version to the line index. Called when a line of this Graph gets a new version
+   */
+  void indexGraphLine(Graph_Line *line, unsigned Version, unsigned lineNumber);
+
+  /**
+   * Return the lines numbered lineNumber in Version of fileName, from the first function in graphFunctions that has any
+   * Answered from the line index without walking the Graph. Several threads may look up lines while none changes it
+   */
+  std::list<Graph_Line *> getIndexedLines(unsigned Version, std::string fileName, unsigned lineNumber);
+
+  /**
+   * Return the lines numbered lineNumber in Version of fileName, from the first function named functionName with any
+   */
+  std::list<Graph_Line *> getIndexedLines(unsigned Version, std::string fileName, unsigned lineNumber,
+                                          std::string functionName);
+
   /**
    * Add sequential edges for the instructions in a Graph_Line
    */
@@ -107,6 +217,7 @@ public:
 
   /**
    * Add branch type edges for ICFG
+   * Functions are processed on graphThreads workers and their edges appended in function order
    */
   void addBranchEdges();
 
@@ -118,6 +229,7 @@ public:
   /**
    * Add function call edges
    * Call only after addVirtualNodes
+   * Call sites are resolved on graphThreads workers and the edges are added in function order
    */
   void addFunctionCallEdges();
 
@@ -128,9 +240,15 @@ public:
 
   /**
    * Print the graph in DOT format
+   * The file is written through a Graph_Writer, on a background thread when graphThreads is above 1
    */
   void printGraph(std::string graphName);
 
+  /**
+   * Print the part of the graph selected by options in the format of options
+   */
+  void printGraph(std::string graphName, const Export_Options &options);
+
   /**
    * Find matching instruction in the ICFG
    * Can return NULL if no match is found
@@ -170,13 +288,72 @@ public:
   std::list<std::string> getWhiteList() { return whiteList; }
 
 private:
+  /**
+   * Kind of callee found at a call site
+   */
+  enum calleeKinds { EXTERNAL_CALLEE, NAMED_CALLEE, UNNAMED_CALLEE };
+
+  /**
+   * Resolved call site waiting for its edges to be added
+   */
+  struct Call_Resolution {
+    Graph_Instruction *callSite;     /**< Instruction making the call */
+    Graph_Instruction *virtualEntry; /**< Entry of the callee. NULL if not found */
+    Graph_Instruction *virtualExit;  /**< Exit of the callee. NULL if not found */
+    std::string calleeName;          /**< Name of the callee */
+    calleeKinds calleeKind;          /**< Kind of callee */
+  };
+
+  /**
+   * Link branch type edges of a single Graph_Function and collect them in branchEdges
+   * Touches only the instructions of func, so different functions can be processed concurrently
+   */
+  void addBranchEdges(Graph_Function *func, std::list<Graph_Edge *> &branchEdges);
+
+  /**
+   * Resolve the callees of all call sites in a single Graph_Function without modifying the Graph
+   * Indirect calls are narrowed with resolver when it is not NULL
+   */
+  void resolveFunctionCalls(Graph_Function *func, Call_Resolver *resolver, std::list<Call_Resolution> &calls);
+
+  /**
+   * Return the LLVM module the instructions of this Graph belong to. NULL if no instruction has a pointer
+   */
+  llvm::Module *getGraphModule();
+
+  /**
+   * Return the ID of fileName in the line index, handing out a new one if it has none
+   */
+  unsigned getFileID(std::string fileName);
+
+  /**
+   * Return the lines indexed for Version, fileName and lineNumber in the order they were indexed. NULL if none are
+   */
+  const std::list<Graph_Line *> *findIndexedLines(unsigned Version, std::string fileName, unsigned lineNumber);
+
+  /**
+   * Return the lines of the first function in graphFunctions among indexedLines, keeping their order
+   * Only functions named functionName are considered, unless it is NULL
+   */
+  std::list<Graph_Line *> getFirstFunctionLines(const std::list<Graph_Line *> &indexedLines,
+                                                const std::string *functionName);
+
   unsigned graphID;                           /**< Unique Graph ID */
   unsigned graphVersion;                      /**< Version of graph. */
   unsigned graphEntryID;                      /**< ID for all virtual entry Node. Set to max -1 */
   unsigned graphExitID;                       /**< ID for all virtual exit Node. Set to max -2 */
+  unsigned graphThreads;                      /**< Number of worker threads used while building */
+  graphGranularities graphGranularity;        /**< What a node in this graph stands for */
+  indirectCallModes graphIndirectCalls;       /**< How indirect calls are resolved */
   std::list<Graph_Edge *> graphEdges;         /**< Container for Edges in the graph */
   std::list<Graph_Function *> graphFunctions; /**< Container for function containers */
   std::list<std::string> whiteList;           /**< Container for white-listed functions */
+  /** Cache of expanded block level nodes */
+  std::map<Graph_Instruction *, std::list<Graph_Instruction *>> graphExpansions;
+  std::map<std::string, unsigned> graphFileIDs;                 /**< File IDs used as keys of the line index */
+  std::unordered_map<Graph_Function *, unsigned> functionOrder; /**< Position of each function in graphFunctions */
+  /** Line index: for each version, lines by file ID in the high and line number in the low 32 bits */
+  std::map<unsigned, std::unordered_map<unsigned long long, std::list<Graph_Line *>>> lineIndex;
 };                                            // End Graph Class
 
 /**
@@ -184,5 +361,12 @@ private:
  * Will return 0 if no information found
  */
 void getLocationInfo(llvm::Instruction &I, unsigned int &DILocLine, std::string &DIFile);
+
+/**
+ * Find the nearest debug location of every instruction in a BasicBlock with one forward and one backward sweep
+ * Entry i follows getLocationInfo: the location of instruction i, else of the closest earlier instruction,
+ * else of the closest later instruction. Entry is NULL if no instruction in the block has a location
+ */
+std::vector<llvm::DILocation *> getBlockLocationTable(llvm::BasicBlock &BB);
 } // namespace hydrogen_framework
 #endif
@@ -0,0 +1,142 @@
+/**
+ * @file
+ * Implementing Graph_Chain.hpp
+ */
+#include "Graph_Chain.hpp"
+#include "Graph.hpp"
+#include "Graph_Edge.hpp"
+#include "Graph_Function.hpp"
+#include "Graph_Instruction.hpp"
+#include "Graph_Line.hpp"
+#include <limits>
+#include <unordered_set>
+namespace hydrogen_framework {
+Graph_Compressed::~Graph_Compressed() {
+  for (auto chain : compressedChains) {
+    delete chain;
+  } // End loop for compressedChains
+  compressedChains.clear();
+  compressedIndex.clear();
+} // End Graph_Compressed destructor
+
+Graph_Chain *Graph_Compressed::getChain(Graph_Instruction *inst) {
+  auto findInst = compressedIndex.find(inst);
+  if (findInst == compressedIndex.end()) {
+    return NULL;
+  } // End check for findInst
+  return findInst->second.first;
+} // End getChain
+
+unsigned Graph_Compressed::getChainPosition(Graph_Instruction *inst) {
+  auto findInst = compressedIndex.find(inst);
+  if (findInst == compressedIndex.end()) {
+    return 0;
+  } // End check for findInst
+  return findInst->second.second;
+} // End getChainPosition
+
+void Graph_Compressed::compressGraph(Graph *graph) {
+  /* Collect instructions in Graph order, then any edge endpoint that is not part of a line */
+  std::vector<Graph_Instruction *> instructions;
+  std::unordered_set<Graph_Instruction *> knownInstructions;
+  for (auto func : graph->getGraphFunctions()) {
+    for (auto line : func->getFunctionLines()) {
+      for (auto inst : line->getLineInstructions()) {
+        if (knownInstructions.insert(inst).second) {
+          instructions.push_back(inst);
+        } // End check for new instruction
+      }   // End loop for inst
+    }     // End loop for line
+  }       // End loop for func
+  std::unordered_map<Graph_Instruction *, std::vector<Graph_Edge *>> outEdges;
+  std::unordered_map<Graph_Instruction *, unsigned> inDegree;
+  for (auto edge : graph->getGraphEdges()) {
+    for (auto inst : {edge->getEdgeFrom(), edge->getEdgeTo()}) {
+      if (knownInstructions.insert(inst).second) {
+        instructions.push_back(inst);
+      } // End check for new instruction
+    }   // End loop for endpoints
+    outEdges[edge->getEdgeFrom()].push_back(edge);
+    ++inDegree[edge->getEdgeTo()];
+  } // End loop for edges
+  /* An instruction continues into its successor when it is the only edge on both sides */
+  std::unordered_map<Graph_Instruction *, Graph_Instruction *> chainNext;
+  for (auto inst : instructions) {
+    auto findEdges = outEdges.find(inst);
+    if (findEdges == outEdges.end() || findEdges->second.size() != 1) {
+      continue;
+    } // End check for single successor
+    Graph_Edge *edge = findEdges->second.front();
+    Graph_Instruction *to = edge->getEdgeTo();
+    if (edge->getEdgeType() == Graph_Edge::SEQUENTIAL && to != inst && inDegree[to] == 1) {
+      chainNext[inst] = to;
+    } // End check for straight-line edge
+  }   // End loop for instructions
+  std::unordered_set<Graph_Instruction *> chainBodies;
+  for (auto &next : chainNext) {
+    chainBodies.insert(next.second);
+  } // End loop for chainNext
+  /* Chains start at every instruction nothing continues into. Remaining instructions can only be on cycles */
+  auto buildChain = [&](Graph_Instruction *head) {
+    Graph_Chain *chain = new Graph_Chain(compressedChains.size());
+    for (Graph_Instruction *inst = head; inst && compressedIndex.find(inst) == compressedIndex.end();) {
+      compressedIndex[inst] = std::make_pair(chain, static_cast<unsigned>(chain->getChainInstructions().size()));
+      chain->pushChainInstruction(inst);
+      auto findNext = chainNext.find(inst);
+      inst = findNext == chainNext.end() ? NULL : findNext->second;
+    } // End loop for chain
+    compressedChains.push_back(chain);
+  };
+  for (auto inst : instructions) {
+    if (chainBodies.find(inst) == chainBodies.end()) {
+      buildChain(inst);
+    } // End check for chain head
+  }   // End loop for instructions
+  for (auto inst : instructions) {
+    if (compressedIndex.find(inst) == compressedIndex.end()) {
+      buildChain(inst);
+    } // End check for unassigned instruction
+  }   // End loop for instructions
+  /* Link chains by the edges leaving their tails */
+  for (auto chain : compressedChains) {
+    auto findEdges = outEdges.find(chain->getChainTail());
+    if (findEdges == outEdges.end()) {
+      continue;
+    } // End check for tail edges
+    for (auto edge : findEdges->second) {
+      auto target = compressedIndex[edge->getEdgeTo()];
+      chain->pushChainSuccessor(target.first, target.second);
+    } // End loop for edges
+  }   // End loop for compressedChains
+} // End compressGraph
+
+std::vector<Graph_Instruction *> Graph_Compressed::getReachableInstructions(Graph_Instruction *start) {
+  std::vector<Graph_Instruction *> reachable;
+  auto findStart = compressedIndex.find(start);
+  if (findStart == compressedIndex.end()) {
+    return reachable;
+  } // End check for findStart
+  /* First position reached in every chain. A chain is listed again only from an earlier position */
+  const unsigned notReached = std::numeric_limits<unsigned>::max();
+  std::vector<unsigned> reachedFrom(compressedChains.size(), notReached);
+  std::list<std::pair<Graph_Chain *, unsigned>> worklist;
+  worklist.push_back(findStart->second);
+  while (!worklist.empty()) {
+    Graph_Chain *chain = worklist.front().first;
+    unsigned position = worklist.front().second;
+    worklist.pop_front();
+    unsigned previous = reachedFrom[chain->getChainID()];
+    if (position >= previous) {
+      continue;
+    } // End check for visited position
+    reachedFrom[chain->getChainID()] = position;
+    const std::vector<Graph_Instruction *> &chainInstructions = chain->getChainInstructions();
+    std::size_t end = previous == notReached ? chainInstructions.size() : previous;
+    reachable.insert(reachable.end(), chainInstructions.begin() + position, chainInstructions.begin() + end);
+    if (previous == notReached) {
+      worklist.insert(worklist.end(), chain->getChainSuccessors().begin(), chain->getChainSuccessors().end());
+    } // End check for first visit
+  }   // End loop for worklist
+  return reachable;
+} // End getReachableInstructions
+} // namespace hydrogen_framework
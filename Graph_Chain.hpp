@@ -0,0 +1,133 @@
+/**
+ * @file
+ * Graph_Chain Class: Straight-line chains of a Graph collapsed into super-nodes for traversal
+ */
+#ifndef GRAPH_CHAIN_H
+#define GRAPH_CHAIN_H
+
+#include <list>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+namespace hydrogen_framework {
+/* Forward declaration */
+class Graph;
+class Graph_Instruction;
+
+/**
+ * Graph_Chain Class: Super-node for a chain of Graph_Instructions linked by SEQUENTIAL edges
+ * Every instruction but the last has exactly one outgoing edge and every instruction but the first has exactly
+ * one incoming edge, so all edges leaving the chain leave from its tail
+ */
+class Graph_Chain {
+public:
+  /**
+   * Constructor
+   */
+  Graph_Chain(unsigned id) : chainID(id) {}
+
+  /**
+   * Destructor
+   */
+  ~Graph_Chain() {
+    chainInstructions.clear();
+    chainSuccessors.clear();
+  }
+
+  /**
+   * Return chainID
+   */
+  unsigned getChainID() { return chainID; }
+
+  /**
+   * Push instruction to the back of chainInstructions
+   */
+  void pushChainInstruction(Graph_Instruction *inst) { chainInstructions.push_back(inst); }
+
+  /**
+   * Return chainInstructions
+   */
+  const std::vector<Graph_Instruction *> &getChainInstructions() { return chainInstructions; }
+
+  /**
+   * Return first instruction of the chain
+   */
+  Graph_Instruction *getChainHead() { return chainInstructions.front(); }
+
+  /**
+   * Return last instruction of the chain
+   */
+  Graph_Instruction *getChainTail() { return chainInstructions.back(); }
+
+  /**
+   * Record that the tail of this chain has an edge to position of successor
+   */
+  void pushChainSuccessor(Graph_Chain *successor, unsigned position) {
+    chainSuccessors.push_back(std::make_pair(successor, position));
+  }
+
+  /**
+   * Return chainSuccessors
+   */
+  const std::vector<std::pair<Graph_Chain *, unsigned>> &getChainSuccessors() { return chainSuccessors; }
+
+private:
+  unsigned chainID;                                                /**< Chain ID. Index in Graph_Compressed */
+  std::vector<Graph_Instruction *> chainInstructions;              /**< Instructions of the chain in order */
+  std::vector<std::pair<Graph_Chain *, unsigned>> chainSuccessors; /**< Chains and positions reached from tail */
+};                                                                 // End Graph_Chain Class
+
+/**
+ * Graph_Compressed Class: Chain compressed view of a Graph
+ * The view is built once from the edges present in the Graph and is not updated when the Graph changes
+ */
+class Graph_Compressed {
+public:
+  /**
+   * Constructor
+   */
+  Graph_Compressed(Graph *graph) { compressGraph(graph); }
+
+  /**
+   * Destructor
+   */
+  ~Graph_Compressed();
+
+  /**
+   * Return the chain that contains inst. Returns NULL for instructions not in the Graph
+   */
+  Graph_Chain *getChain(Graph_Instruction *inst);
+
+  /**
+   * Return position of inst in its chain
+   */
+  unsigned getChainPosition(Graph_Instruction *inst);
+
+  /**
+   * Return true if inst starts its chain
+   */
+  bool isChainHead(Graph_Instruction *inst) { return getChain(inst) && getChainPosition(inst) == 0; }
+
+  /**
+   * Return compressedChains
+   */
+  const std::vector<Graph_Chain *> &getChains() { return compressedChains; }
+
+  /**
+   * Return every instruction reachable from start along outgoing edges, start included
+   * Chains are visited breadth first and each chain is listed in order from the first reached position
+   */
+  std::vector<Graph_Instruction *> getReachableInstructions(Graph_Instruction *start);
+
+private:
+  /**
+   * Collapse the straight-line chains of graph and link the chains by the remaining edges
+   */
+  void compressGraph(Graph *graph);
+
+  std::vector<Graph_Chain *> compressedChains; /**< Container for chains in Graph order */
+  /** Chain and position of every instruction */
+  std::unordered_map<Graph_Instruction *, std::pair<Graph_Chain *, unsigned>> compressedIndex;
+};                                             // End Graph_Compressed Class
+} // namespace hydrogen_framework
+#endif
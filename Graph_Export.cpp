@@ -0,0 +1,441 @@
+/**
+ * @file
+ * Implementing Graph_Export.hpp
+ */
+#include "Graph_Export.hpp"
+#include "Graph.hpp"
+#include "Graph_Edge.hpp"
+#include "Graph_Function.hpp"
+#include "Graph_Instruction.hpp"
+#include "Graph_Line.hpp"
+#include "Graph_Writer.hpp"
+#include "Parallel_Util.hpp"
+#include <cstring>
+#include <deque>
+#include <unordered_map>
+namespace hydrogen_framework {
+/**
+ * Return the exported name of the type of edge
+ */
+static const char *getEdgeTypeName(Graph_Edge *edge) {
+  switch (edge->getEdgeType()) {
+  case Graph_Edge::SEQUENTIAL:
+    return "sequential";
+  case Graph_Edge::BRANCH:
+    return "branch";
+  case Graph_Edge::CALL:
+    return "call";
+  case Graph_Edge::EXTERNAL_CALL:
+    return "external_call";
+  case Graph_Edge::VIRTUAL:
+    return "virtual";
+  case Graph_Edge::MVICFG_ADD:
+    return "add";
+  case Graph_Edge::MVICFG_DEL:
+    return "del";
+  case Graph_Edge::ANY:
+    break;
+  } // End switch for edge
+  return "any";
+} // End getEdgeTypeName
+
+/**
+ * Return the opcode of the first LLVM instruction of inst. Empty for virtual nodes
+ */
+static std::string getNodeOpcode(Graph_Instruction *inst) {
+  if (!inst->getInstructionPtr()) {
+    return "";
+  } // End check for instructionPtr
+  return inst->getInstructionPtr()->getOpcodeName();
+} // End getNodeOpcode
+
+void DOT_Format::writeHeader(Graph_Writer &writer, const std::string &label) {
+  writer.append("digraph \"MVICFG\" {\n");
+  writer.append("\tlabel=\"");
+  writer.append(label);
+  writer.append("\";\n");
+  writer.append("/* Generating Nodes */\n");
+} // End writeHeader
+
+void DOT_Format::writeFunctionBegin(Graph_Writer &writer, Graph_Function *func) {
+  writer.append("\tsubgraph cluster_");
+  writer.appendNumber(func->getFunctionID());
+  writer.append(" {\n\t\tlabel=\"");
+  writer.append(func->getFunctionName());
+  writer.append("\";\n");
+} // End writeFunctionBegin
+
+void DOT_Format::writeNode(Graph_Writer &writer, Graph_Function * /* func */, Graph_Line *line,
+                           Graph_Instruction *inst, unsigned lineVersion) {
+  writer.append("\t\t\"");
+  writer.appendNumber(inst->getInstructionID());
+  writer.append("\" [label=\"");
+  writer.appendNumber(line->getLineNumber(lineVersion));
+  writer.append("::");
+  /* Left justify one instruction per row for block level nodes */
+  writer.appendDOTString(inst->getInstructionLabel(), inst->getInstructionCount() > 1);
+  writer.append("\"];\n");
+} // End writeNode
+
+void DOT_Format::writeFunctionEnd(Graph_Writer &writer, Graph_Function * /* func */) { writer.append("\t}\n"); }
+
+void DOT_Format::writeEdgesBegin(Graph_Writer &writer) { writer.append("\n/* Generating Edges */\n"); }
+
+void DOT_Format::writeEdge(Graph_Writer &writer, Graph_Edge *edge) {
+  writer.append("\t\t\"");
+  writer.appendNumber(edge->getEdgeFrom()->getInstructionID());
+  writer.append("\" -> \"");
+  writer.appendNumber(edge->getEdgeTo()->getInstructionID());
+  const char *style = "\" [arrowhead = normal, penwidth = 1.0, color = black, label=\"";
+  const char *suffix = "";
+  switch (edge->getEdgeType()) {
+  case Graph_Edge::SEQUENTIAL:
+    break;
+  case Graph_Edge::BRANCH:
+    style = "\" [arrowhead = dot, penwidth = 1.0, color = black, label=\"";
+    suffix = "::Branch";
+    break;
+  case Graph_Edge::VIRTUAL:
+    style = "\" [arrowhead = normal, penwidth = 1.0, color = pink, label=\"";
+    suffix = "::Virtual";
+    break;
+  case Graph_Edge::CALL:
+    style = "\" [arrowhead = odot, penwidth = 1.0, color = blue, label=\"";
+    suffix = "::Call";
+    break;
+  case Graph_Edge::EXTERNAL_CALL:
+    style = "\" [arrowhead = odot, penwidth = 1.0, color = yellow, label=\"";
+    suffix = "::External_Call";
+    break;
+  case Graph_Edge::MVICFG_ADD:
+    style = "\" [arrowhead = normal, penwidth = 1.0, color = green, label=\"";
+    suffix = "::Add";
+    break;
+  case Graph_Edge::MVICFG_DEL:
+    style = "\" [arrowhead = normal, penwidth = 1.0, color = red, label=\"";
+    suffix = "::Del";
+    break;
+  case Graph_Edge::ANY:
+    std::cerr << "Should not have ANY as edgeType\n";
+    style = "\" [arrowhead = normal, penwidth = 2.0, color = red, label=\"";
+    suffix = "::ANY";
+    break;
+  } // End switch for edge
+  writer.append(style, std::strlen(style));
+  bool firstVersion = true;
+  for (auto ver : edge->getEdgeVersions()) {
+    if (!firstVersion) {
+      writer.append(",");
+    } // End check for firstVersion
+    writer.append("V");
+    writer.appendNumber(ver);
+    firstVersion = false;
+  } // End loop for edgeVersions
+  writer.append(suffix, std::strlen(suffix));
+  writer.append("\"];\n");
+} // End writeEdge
+
+void DOT_Format::writeFooter(Graph_Writer &writer) { writer.append("}\n"); }
+
+void GraphML_Format::writeHeader(Graph_Writer &writer, const std::string &label) {
+  writer.append("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                "<graphml xmlns=\"http://graphml.graphdrawing.org/xmlns\">\n"
+                "  <key id=\"function\" for=\"node\" attr.name=\"function\" attr.type=\"string\"/>\n"
+                "  <key id=\"file\" for=\"node\" attr.name=\"file\" attr.type=\"string\"/>\n"
+                "  <key id=\"line\" for=\"node\" attr.name=\"line\" attr.type=\"long\"/>\n"
+                "  <key id=\"lines\" for=\"node\" attr.name=\"lines\" attr.type=\"string\"/>\n"
+                "  <key id=\"opcode\" for=\"node\" attr.name=\"opcode\" attr.type=\"string\"/>\n"
+                "  <key id=\"label\" for=\"node\" attr.name=\"label\" attr.type=\"string\"/>\n"
+                "  <key id=\"type\" for=\"edge\" attr.name=\"type\" attr.type=\"string\"/>\n"
+                "  <key id=\"versions\" for=\"edge\" attr.name=\"versions\" attr.type=\"string\"/>\n"
+                "  <graph id=\"");
+  writer.appendXMLString(label);
+  writer.append("\" edgedefault=\"directed\">\n");
+} // End writeHeader
+
+void GraphML_Format::writeNode(Graph_Writer &writer, Graph_Function *func, Graph_Line *line, Graph_Instruction *inst,
+                               unsigned lineVersion) {
+  writer.append("    <node id=\"n");
+  writer.appendNumber(inst->getInstructionID());
+  writer.append("\">\n      <data key=\"function\">");
+  writer.appendXMLString(func->getFunctionName());
+  writer.append("</data>\n      <data key=\"file\">");
+  writer.appendXMLString(func->getFunctionFile());
+  writer.append("</data>\n      <data key=\"line\">");
+  writer.appendNumber(line->getLineNumber(lineVersion));
+  /* Line number of every version as version:line pairs */
+  writer.append("</data>\n      <data key=\"lines\">");
+  bool firstVersion = true;
+  for (auto &lineNumber : line->getLineNumbers()) {
+    if (!firstVersion) {
+      writer.append(",");
+    } // End check for firstVersion
+    writer.appendNumber(lineNumber.first);
+    writer.append(":");
+    writer.appendNumber(lineNumber.second);
+    firstVersion = false;
+  } // End loop for lineNumbers
+  writer.append("</data>\n      <data key=\"opcode\">");
+  writer.append(getNodeOpcode(inst));
+  writer.append("</data>\n      <data key=\"label\">");
+  writer.appendXMLString(inst->getInstructionLabel());
+  writer.append("</data>\n    </node>\n");
+} // End writeNode
+
+void GraphML_Format::writeEdge(Graph_Writer &writer, Graph_Edge *edge) {
+  writer.append("    <edge source=\"n");
+  writer.appendNumber(edge->getEdgeFrom()->getInstructionID());
+  writer.append("\" target=\"n");
+  writer.appendNumber(edge->getEdgeTo()->getInstructionID());
+  writer.append("\">\n      <data key=\"type\">");
+  const char *typeName = getEdgeTypeName(edge);
+  writer.append(typeName, std::strlen(typeName));
+  writer.append("</data>\n      <data key=\"versions\">");
+  bool firstVersion = true;
+  for (auto ver : edge->getEdgeVersions()) {
+    if (!firstVersion) {
+      writer.append(",");
+    } // End check for firstVersion
+    writer.appendNumber(ver);
+    firstVersion = false;
+  } // End loop for edgeVersions
+  writer.append("</data>\n    </edge>\n");
+} // End writeEdge
+
+void GraphML_Format::writeFooter(Graph_Writer &writer) { writer.append("  </graph>\n</graphml>\n"); }
+
+void NDJSON_Format::writeHeader(Graph_Writer &writer, const std::string &label) {
+  writer.append("{\"kind\":\"graph\",\"label\":");
+  writer.appendJSONString(label);
+  writer.append("}\n");
+} // End writeHeader
+
+void NDJSON_Format::writeNode(Graph_Writer &writer, Graph_Function *func, Graph_Line *line, Graph_Instruction *inst,
+                              unsigned lineVersion) {
+  writer.append("{\"kind\":\"node\",\"id\":");
+  writer.appendNumber(inst->getInstructionID());
+  writer.append(",\"function\":");
+  writer.appendJSONString(func->getFunctionName());
+  writer.append(",\"file\":");
+  writer.appendJSONString(func->getFunctionFile());
+  writer.append(",\"line\":");
+  writer.appendNumber(line->getLineNumber(lineVersion));
+  /* Line number of every version keyed by version */
+  writer.append(",\"lines\":{");
+  bool firstVersion = true;
+  for (auto &lineNumber : line->getLineNumbers()) {
+    writer.append(firstVersion ? "\"" : ",\"");
+    writer.appendNumber(lineNumber.first);
+    writer.append("\":");
+    writer.appendNumber(lineNumber.second);
+    firstVersion = false;
+  } // End loop for lineNumbers
+  writer.append("},\"opcode\":");
+  writer.appendJSONString(getNodeOpcode(inst));
+  writer.append(",\"label\":");
+  writer.appendJSONString(inst->getInstructionLabel());
+  writer.append("}\n");
+} // End writeNode
+
+void NDJSON_Format::writeEdge(Graph_Writer &writer, Graph_Edge *edge) {
+  writer.append("{\"kind\":\"edge\",\"from\":");
+  writer.appendNumber(edge->getEdgeFrom()->getInstructionID());
+  writer.append(",\"to\":");
+  writer.appendNumber(edge->getEdgeTo()->getInstructionID());
+  writer.append(",\"type\":\"");
+  const char *typeName = getEdgeTypeName(edge);
+  writer.append(typeName, std::strlen(typeName));
+  writer.append("\",\"versions\":[");
+  bool firstVersion = true;
+  for (auto ver : edge->getEdgeVersions()) {
+    if (!firstVersion) {
+      writer.append(",");
+    } // End check for firstVersion
+    writer.appendNumber(ver);
+    firstVersion = false;
+  } // End loop for edgeVersions
+  writer.append("]}\n");
+} // End writeEdge
+
+Graph_Export::Graph_Export(Graph *graph, const Export_Options &options)
+    : exportGraph(graph), exportOptions(options),
+      exportLineVersion(options.exportVersion ? options.exportVersion : graph->getGraphVersion()) {
+  selectNodes();
+} // End Graph_Export
+
+bool Graph_Export::isEdgeTypeSelected(Graph_Edge *edge) {
+  if (!(exportOptions.exportEdgeTypes & (1u << edge->getEdgeType()))) {
+    return false;
+  } // End check for edge type
+  return exportOptions.exportVersion == 0 || edge->isPartOfGraph(exportOptions.exportVersion);
+} // End isEdgeTypeSelected
+
+bool Graph_Export::isSelected(Graph_Edge *edge) {
+  return isEdgeTypeSelected(edge) && isSelected(edge->getEdgeFrom()) && isSelected(edge->getEdgeTo());
+} // End isSelected
+
+void Graph_Export::selectNodes() {
+  /* Nodes of the selected functions and version in Graph order */
+  std::vector<Graph_Instruction *> candidates;
+  std::unordered_map<unsigned, Graph_Instruction *> candidateIDs;
+  for (auto func : exportGraph->getGraphFunctions()) {
+    if (!exportOptions.exportFunctions.empty() &&
+        exportOptions.exportFunctions.find(func->getFunctionName()) == exportOptions.exportFunctions.end()) {
+      continue;
+    } // End check for exportFunctions
+    for (auto line : func->getFunctionLines()) {
+      if (exportOptions.exportVersion && line->getLineNumber(exportOptions.exportVersion) == 0) {
+        continue;
+      } // End check for exportVersion
+      for (auto inst : line->getLineInstructions()) {
+        candidates.push_back(inst);
+        candidateIDs.insert(std::make_pair(inst->getInstructionID(), inst));
+      } // End loop for inst
+    }   // End loop for line
+  }     // End loop for func
+  if (exportOptions.exportCenter) {
+    auto findCenter = candidateIDs.find(exportOptions.exportCenter);
+    if (findCenter == candidateIDs.end()) {
+      std::cerr << "Export center " << exportOptions.exportCenter << " is not part of the selected graph\n";
+      return;
+    } // End check for findCenter
+    /* Breadth first from the center so the closest nodes come first */
+    std::vector<Graph_Instruction *> ordered;
+    std::unordered_map<Graph_Instruction *, unsigned> distance;
+    std::deque<Graph_Instruction *> worklist;
+    distance[findCenter->second] = 0;
+    worklist.push_back(findCenter->second);
+    while (!worklist.empty()) {
+      Graph_Instruction *node = worklist.front();
+      worklist.pop_front();
+      ordered.push_back(node);
+      unsigned nodeDistance = distance[node];
+      if (nodeDistance == exportOptions.exportRadius) {
+        continue;
+      } // End check for exportRadius
+      for (auto edge : node->getInstructionEdges()) {
+        if (!isEdgeTypeSelected(edge)) {
+          continue;
+        } // End check for isEdgeTypeSelected
+        Graph_Instruction *other = edge->getEdgeFrom() == node ? edge->getEdgeTo() : edge->getEdgeFrom();
+        auto findOther = candidateIDs.find(other->getInstructionID());
+        if (findOther == candidateIDs.end() || findOther->second != other || distance.count(other)) {
+          continue;
+        } // End check for unvisited candidate
+        distance[other] = nodeDistance + 1;
+        worklist.push_back(other);
+      } // End loop for edges
+    }   // End loop for worklist
+    candidates.swap(ordered);
+  } // End check for exportCenter
+  if (exportOptions.exportNodeBudget && candidates.size() > exportOptions.exportNodeBudget) {
+    std::cerr << "Export stopped at the node budget of " << exportOptions.exportNodeBudget << " out of "
+              << candidates.size() << " nodes\n";
+    candidates.resize(exportOptions.exportNodeBudget);
+  } // End check for exportNodeBudget
+  exportNodes.insert(candidates.begin(), candidates.end());
+} // End selectNodes
+
+bool Graph_Export::writeGraph(std::string graphName) {
+  DOT_Format dotFormat;
+  GraphML_Format graphmlFormat;
+  NDJSON_Format ndjsonFormat;
+  Export_Format *format = &dotFormat;
+  if (exportOptions.exportFormat == Export_Options::GRAPHML) {
+    format = &graphmlFormat;
+  } else if (exportOptions.exportFormat == Export_Options::NDJSON) {
+    format = &ndjsonFormat;
+  } // End check for exportFormat
+  std::string extension = "." + format->getExtension();
+  std::list<Graph_Function *> graphFunctions = exportGraph->getGraphFunctions();
+  if (!exportOptions.exportPerFunction) {
+    std::vector<Graph_Function *> funcs(graphFunctions.begin(), graphFunctions.end());
+    std::vector<Graph_Edge *> edges;
+    for (auto edge : exportGraph->getGraphEdges()) {
+      if (isSelected(edge)) {
+        edges.push_back(edge);
+      } // End check for isSelected
+    }   // End loop for edges
+    return writeFile(*format, graphName + extension, graphName, funcs, edges, exportOptions.exportThreads > 1);
+  } // End check for exportPerFunction
+  /* One file per function with exported nodes */
+  std::vector<Graph_Function *> funcs;
+  for (auto func : graphFunctions) {
+    bool hasNodes = false;
+    for (auto line : func->getFunctionLines()) {
+      for (auto inst : line->getLineInstructions()) {
+        hasNodes = hasNodes || isSelected(inst);
+      } // End loop for inst
+    }   // End loop for line
+    if (hasNodes) {
+      funcs.push_back(func);
+    } // End check for hasNodes
+  }   // End loop for func
+  std::vector<char> written(funcs.size(), 0);
+  parallelFor(funcs.size(), exportOptions.exportThreads, [&](std::size_t index) {
+    Graph_Function *func = funcs[index];
+    std::vector<Graph_Edge *> edges;
+    std::unordered_set<Graph_Edge *> seen;
+    for (auto line : func->getFunctionLines()) {
+      for (auto inst : line->getLineInstructions()) {
+        if (!isSelected(inst)) {
+          continue;
+        } // End check for isSelected
+        for (auto edge : inst->getInstructionEdges()) {
+          if (edge->getEdgeFrom() == inst && isSelected(edge) && seen.insert(edge).second) {
+            edges.push_back(edge);
+          } // End check for outgoing edge
+        }   // End loop for edges
+      }     // End loop for inst
+    }       // End loop for line
+    std::vector<Graph_Function *> single(1, func);
+    written[index] = writeFile(*format, graphName + "_" + std::to_string(func->getFunctionID()) + extension,
+                               graphName + "::" + func->getFunctionName(), single, edges, false);
+  });
+  for (auto ok : written) {
+    if (!ok) {
+      return false;
+    } // End check for written
+  }   // End loop for written
+  return true;
+} // End writeGraph
+
+bool Graph_Export::writeFile(Export_Format &format, std::string path, std::string label,
+                             const std::vector<Graph_Function *> &funcs, const std::vector<Graph_Edge *> &edges,
+                             bool background) {
+  Graph_Writer gFile(path, background);
+  if (!gFile.isOpen()) {
+    std::cerr << "Unable to open file for printing the output\n";
+    return false;
+  } // End check for gFile
+  format.writeHeader(gFile, label);
+  for (auto func : funcs) {
+    bool openFunction = false;
+    for (auto line : func->getFunctionLines()) {
+      for (auto inst : line->getLineInstructions()) {
+        if (!isSelected(inst)) {
+          continue;
+        } // End check for isSelected
+        if (!openFunction) {
+          format.writeFunctionBegin(gFile, func);
+          openFunction = true;
+        } // End check for openFunction
+        format.writeNode(gFile, func, line, inst, exportLineVersion);
+      } // End loop for inst
+    }   // End loop for line
+    if (openFunction) {
+      format.writeFunctionEnd(gFile, func);
+    } // End check for openFunction
+  }   // End loop for func
+  format.writeEdgesBegin(gFile);
+  for (auto edge : edges) {
+    format.writeEdge(gFile, edge);
+  } // End loop for edge
+  format.writeFooter(gFile);
+  if (!gFile.closeWriter()) {
+    std::cerr << "Unable to write " << path << "\n";
+    return false;
+  } // End check for closeWriter
+  return true;
+} // End writeFile
+} // namespace hydrogen_framework
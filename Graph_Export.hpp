@@ -0,0 +1,281 @@
+/**
+ * @file
+ * Graph_Export Class: Filtered and sharded export of a Graph in DOT, GraphML or NDJSON
+ */
+#ifndef GRAPH_EXPORT_H
+#define GRAPH_EXPORT_H
+
+#include <cstddef>
+#include <set>
+#include <string>
+#include <unordered_set>
+#include <vector>
+namespace hydrogen_framework {
+/* Forward declaration */
+class Graph;
+class Graph_Edge;
+class Graph_Function;
+class Graph_Instruction;
+class Graph_Line;
+class Graph_Writer;
+
+/**
+ * Export_Options: Selects the part of a Graph that is exported and how it is split into files
+ * The default options export the whole Graph into a single file
+ */
+struct Export_Options {
+  /**
+   * Output formats
+   */
+  enum exportFormats { DOT, GRAPHML, NDJSON };
+
+  /**
+   * Constructor
+   * Sets the options that export everything
+   */
+  Export_Options()
+      : exportFormat(DOT), exportEdgeTypes(~0u), exportVersion(0), exportNodeBudget(0), exportCenter(0),
+        exportRadius(0), exportPerFunction(false), exportThreads(1) {}
+
+  exportFormats exportFormat;            /**< Format of the written files */
+  std::set<std::string> exportFunctions; /**< Names of the functions to export. All functions if empty */
+  unsigned exportEdgeTypes;              /**< Bit 1 << Graph_Edge::edgeTypes set for every edge type to export */
+  unsigned exportVersion;                /**< Only export nodes and edges of this version. All versions if 0 */
+  std::size_t exportNodeBudget;          /**< Stop after this many nodes. No limit if 0 */
+  unsigned exportCenter;                 /**< Only export the neighborhood of this node ID. Whole Graph if 0 */
+  unsigned exportRadius;                 /**< Number of edges from exportCenter included in the neighborhood */
+  bool exportPerFunction;                /**< Write one file per function instead of a single file */
+  unsigned exportThreads;                /**< Worker threads for writing files */
+};
+
+/**
+ * Export_Format Class: Output format of Graph_Export
+ * Graph_Export walks the selection once and calls the format for every function, node and edge, in that order.
+ * Formats keep no state, so one format can write several files at once
+ */
+class Export_Format {
+public:
+  /**
+   * Destructor
+   */
+  virtual ~Export_Format() {}
+
+  /**
+   * Return the file extension of the format
+   */
+  virtual std::string getExtension() = 0;
+
+  /**
+   * Write the start of a document named label
+   */
+  virtual void writeHeader(Graph_Writer &writer, const std::string &label) = 0;
+
+  /**
+   * Write the start of func. Called before its first exported node
+   */
+  virtual void writeFunctionBegin(Graph_Writer & /* writer */, Graph_Function * /* func */) {}
+
+  /**
+   * Write inst of line in func. lineVersion is the version whose line number is primary
+   */
+  virtual void writeNode(Graph_Writer &writer, Graph_Function *func, Graph_Line *line, Graph_Instruction *inst,
+                         unsigned lineVersion) = 0;
+
+  /**
+   * Write the end of func. Called after its last exported node
+   */
+  virtual void writeFunctionEnd(Graph_Writer & /* writer */, Graph_Function * /* func */) {}
+
+  /**
+   * Write what separates the nodes from the edges
+   */
+  virtual void writeEdgesBegin(Graph_Writer & /* writer */) {}
+
+  /**
+   * Write edge
+   */
+  virtual void writeEdge(Graph_Writer &writer, Graph_Edge *edge) = 0;
+
+  /**
+   * Write the end of the document
+   */
+  virtual void writeFooter(Graph_Writer &writer) = 0;
+}; // End Export_Format Class
+
+/**
+ * DOT_Format Class: Graphviz DOT with a cluster per function
+ */
+class DOT_Format : public Export_Format {
+public:
+  /**
+   * Return the file extension
+   */
+  std::string getExtension() { return "dot"; }
+
+  /**
+   * Write the document header
+   */
+  void writeHeader(Graph_Writer &writer, const std::string &label);
+
+  /**
+   * Write the start of func
+   */
+  void writeFunctionBegin(Graph_Writer &writer, Graph_Function *func);
+
+  /**
+   * Write inst
+   */
+  void writeNode(Graph_Writer &writer, Graph_Function *func, Graph_Line *line, Graph_Instruction *inst,
+                 unsigned lineVersion);
+
+  /**
+   * Write the end of func
+   */
+  void writeFunctionEnd(Graph_Writer &writer, Graph_Function *func);
+
+  /**
+   * Write the edge section header
+   */
+  void writeEdgesBegin(Graph_Writer &writer);
+
+  /**
+   * Write edge
+   */
+  void writeEdge(Graph_Writer &writer, Graph_Edge *edge);
+
+  /**
+   * Write the document footer
+   */
+  void writeFooter(Graph_Writer &writer);
+}; // End DOT_Format Class
+
+/**
+ * GraphML_Format Class: GraphML with node and edge attributes declared as keys
+ */
+class GraphML_Format : public Export_Format {
+public:
+  /**
+   * Return the file extension
+   */
+  std::string getExtension() { return "graphml"; }
+
+  /**
+   * Write the document header
+   */
+  void writeHeader(Graph_Writer &writer, const std::string &label);
+
+  /**
+   * Write inst
+   */
+  void writeNode(Graph_Writer &writer, Graph_Function *func, Graph_Line *line, Graph_Instruction *inst,
+                 unsigned lineVersion);
+
+  /**
+   * Write edge
+   */
+  void writeEdge(Graph_Writer &writer, Graph_Edge *edge);
+
+  /**
+   * Write the document footer
+   */
+  void writeFooter(Graph_Writer &writer);
+}; // End GraphML_Format Class
+
+/**
+ * NDJSON_Format Class: One JSON object per line for the graph, each node and each edge
+ */
+class NDJSON_Format : public Export_Format {
+public:
+  /**
+   * Return the file extension
+   */
+  std::string getExtension() { return "ndjson"; }
+
+  /**
+   * Write the document header
+   */
+  void writeHeader(Graph_Writer &writer, const std::string &label);
+
+  /**
+   * Write inst
+   */
+  void writeNode(Graph_Writer &writer, Graph_Function *func, Graph_Line *line, Graph_Instruction *inst,
+                 unsigned lineVersion);
+
+  /**
+   * Write edge
+   */
+  void writeEdge(Graph_Writer &writer, Graph_Edge *edge);
+
+  /**
+   * Write the document footer
+   */
+  void writeFooter(Graph_Writer & /* writer */) {}
+}; // End NDJSON_Format Class
+
+/**
+ * Graph_Export Class: Writes the nodes and edges of a Graph selected by Export_Options
+ * An edge is exported only if its type and version are selected and both of its nodes are exported.
+ * The neighborhood of exportCenter follows selected edges in both directions. When a node budget is set the nodes
+ * closest to exportCenter, or the first nodes in Graph order, are kept
+ */
+class Graph_Export {
+public:
+  /**
+   * Constructor
+   * Selects the nodes to export
+   */
+  Graph_Export(Graph *graph, const Export_Options &options);
+
+  /**
+   * Destructor
+   */
+  ~Graph_Export() { exportNodes.clear(); }
+
+  /**
+   * Return true if inst is exported
+   */
+  bool isSelected(Graph_Instruction *inst) { return exportNodes.find(inst) != exportNodes.end(); }
+
+  /**
+   * Return true if edge is exported
+   */
+  bool isSelected(Graph_Edge *edge);
+
+  /**
+   * Return the number of exported nodes
+   */
+  std::size_t getSelectedCount() { return exportNodes.size(); }
+
+  /**
+   * Write the selection in exportFormat to graphName.<extension>
+   * With exportPerFunction every function with exported nodes is written to graphName_<functionID>.<extension>
+   * instead, holding the edges that leave its nodes. Files are written on exportThreads workers
+   * Returns FALSE if a file could not be written
+   */
+  bool writeGraph(std::string graphName);
+
+private:
+  /**
+   * Return true if the type and version of edge are selected, regardless of its nodes
+   */
+  bool isEdgeTypeSelected(Graph_Edge *edge);
+
+  /**
+   * Fill exportNodes from the options
+   */
+  void selectNodes();
+
+  /**
+   * Write a file in format with the exported nodes of funcs and the given edges
+   */
+  bool writeFile(Export_Format &format, std::string path, std::string label,
+                 const std::vector<Graph_Function *> &funcs, const std::vector<Graph_Edge *> &edges, bool background);
+
+  Graph *exportGraph;                                  /**< Graph being exported */
+  Export_Options exportOptions;                        /**< Selection and layout of the export */
+  unsigned exportLineVersion;                          /**< Version whose line numbers are printed */
+  std::unordered_set<Graph_Instruction *> exportNodes; /**< Nodes selected for export */
+};                                                     // End Graph_Export Class
+} // namespace hydrogen_framework
+#endif
@@ -73,6 +73,11 @@ public:
    */
   unsigned getFunctionID() { return functionID; }
 
+  /**
+   * Set functionID
+   */
+  void setFunctionID(unsigned id) { functionID = id; }
+
   /**
    * Return functionFile
    */
@@ -9,6 +9,7 @@
 #include <list>
 #include <llvm/IR/Module.h>
 #include <set>
+#include <vector>
 namespace hydrogen_framework {
 /* Forward declaration */
 class Graph_Edge;
@@ -23,7 +24,8 @@ public:
   /**
    * Constructor
    */
-  Graph_Instruction() : instructionID(0), instructionPtr(NULL), instructionLine(NULL) {}
+  Graph_Instruction()
+      : instructionID(0), instructionPtr(NULL), instructionLast(NULL), instructionCount(1), instructionLine(NULL) {}
 
   /**
    * Destructor
@@ -66,6 +68,50 @@ public:
    */
   llvm::Instruction *getInstructionPtr() { return instructionPtr; }
 
+  /**
+   * Extend a block level node by the LLVM instruction following the last one it covers
+   * The label of the instruction is appended to instructionLabel on a new line
+   */
+  void pushRangeInstruction(llvm::Instruction *I, std::string label) {
+    instructionLast = I;
+    instructionLabel.append("\n").append(label);
+    ++instructionCount;
+  }
+
+  /**
+   * Set the last LLVM instruction and the number of instructions covered by this node
+   * Used when restoring a node whose label already holds the whole range
+   */
+  void setInstructionRange(llvm::Instruction *last, unsigned count) {
+    instructionLast = count > 1 ? last : NULL;
+    instructionCount = count;
+  }
+
+  /**
+   * Return the last LLVM instruction covered by this node
+   * Same as instructionPtr for instruction level nodes. Can return NULL
+   */
+  llvm::Instruction *getLastInstructionPtr() { return instructionLast ? instructionLast : instructionPtr; }
+
+  /**
+   * Return instructionCount
+   */
+  unsigned getInstructionCount() { return instructionCount; }
+
+  /**
+   * Return the LLVM instructions covered by this node in program order
+   * Returns empty vector for virtual nodes
+   */
+  std::vector<llvm::Instruction *> getInstructionRange() {
+    std::vector<llvm::Instruction *> range;
+    llvm::Instruction *I = instructionPtr;
+    for (unsigned count = 0; I && count < instructionCount; ++count) {
+      range.push_back(I);
+      I = I->getNextNode();
+    } // End loop for instructionCount
+    return range;
+  }
+
   /**
    * Return instructionEdges
    */
@@ -95,6 +141,8 @@ private:
   unsigned instructionID;                      /**< Instruction ID */
   std::string instructionLabel;                /**< Instruction label or text */
   llvm::Instruction *instructionPtr;           /**< Instruction LLVM Pointer */
+  llvm::Instruction *instructionLast;          /**< Last LLVM instruction of a block level node. NULL otherwise */
+  unsigned instructionCount;                   /**< Number of LLVM instructions covered by this node */
   std::list<Graph_Edge *> instructionEdges;    /**< Container for edges in the instruction */
   Graph_Line *instructionLine;                 /**< Points to the Graph_Line that encompasses this */
   std::set<Query *> instructionVisitedQueries; /**< Container for Queries that have visited this */
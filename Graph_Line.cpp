@@ -4,12 +4,18 @@
  * Implementing Graph_Line.hpp
  */
 #include "Graph_Line.hpp"
+#include "Graph.hpp"
+#include "Graph_Function.hpp"
 #include "Graph_Instruction.hpp"
 
 namespace hydrogen_framework {
 
 void Graph_Line::setLineNumber(unsigned Version, unsigned line) {
-  lineNumber.insert(std::pair<unsigned, unsigned>(Version, line));
+  bool inserted = lineNumber.insert(std::pair<unsigned, unsigned>(Version, line)).second;
+  /* Numbers are never replaced, so the index only needs to hear about new versions of lines already in a Graph */
+  if (inserted && lineFunction && lineFunction->getGraph()) {
+    lineFunction->getGraph()->indexGraphLine(this, Version, line);
+  } // End check for inserted
 } // End setLineNumber
 
 void Graph_Line::pushLineInstruction(Graph_Instruction *inst) {
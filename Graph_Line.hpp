@@ -34,6 +34,11 @@ public:
    */
   unsigned getLineNumber(unsigned Version);
 
+  /**
+   * Return lineNumber for all versions
+   */
+  std::map<unsigned, unsigned> getLineNumbers() { return lineNumber; }
+
   /**
    * Set lineNumber
    */
@@ -0,0 +1,446 @@
+/**
+ * @file
+ * Implementing Graph_Snapshot.hpp
+ */
+#include "Graph_Snapshot.hpp"
+#include "Graph.hpp"
+#include "Graph_Edge.hpp"
+#include "Graph_Function.hpp"
+#include "Graph_Instruction.hpp"
+#include "Graph_Line.hpp"
+#include "Module.hpp"
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+namespace hydrogen_framework {
+/**
+ * Magic bytes at the start of every snapshot
+ */
+static const char snapshotMagic[8] = {'H', 'Y', 'D', 'G', 'R', 'A', 'P', 'H'};
+
+/**
+ * Layout version written into new snapshots. Bump whenever a record changes
+ */
+static const uint32_t snapshotFormatVersion = 1;
+
+/**
+ * Round offset up to the alignment of every section
+ */
+static uint64_t alignSection(uint64_t offset) { return (offset + 7) & ~static_cast<uint64_t>(7); }
+
+/**
+ * Map the whole file at path read-only. Returns NULL if it cannot be mapped
+ * Empty files are reported through size with a NULL mapping
+ */
+static const unsigned char *mapFile(std::string path, std::size_t &size) {
+  size = 0;
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd == -1) {
+    return NULL;
+  } // End check for open
+  struct stat buffer;
+  if (fstat(fd, &buffer) == -1 || buffer.st_size == 0) {
+    close(fd);
+    return NULL;
+  } // End check for fstat
+  void *data = mmap(NULL, buffer.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    return NULL;
+  } // End check for mmap
+  size = buffer.st_size;
+  return static_cast<const unsigned char *>(data);
+} // End mapFile
+
+uint64_t Graph_Snapshot::hashFile(std::string path) {
+  std::size_t size;
+  const unsigned char *data = mapFile(path, size);
+  if (!data) {
+    return 0;
+  } // End check for data
+  uint64_t hash = 14695981039346656037ULL;
+  for (std::size_t index = 0; index < size; ++index) {
+    hash ^= data[index];
+    hash *= 1099511628211ULL;
+  } // End loop for data
+  munmap(const_cast<unsigned char *>(data), size);
+  return hash;
+} // End hashFile
+
+uint32_t Graph_Snapshot::getBuildFlags(Graph *graph, Module *mod) {
+  return static_cast<uint32_t>(graph->getGraphGranularity()) |
+         (static_cast<uint32_t>(graph->getGraphIndirectCalls()) << 8) | (mod->isReachableOnly() ? 1u << 16 : 0);
+} // End getBuildFlags
+
+bool Graph_Snapshot::writeSnapshot(std::string path, Graph *graph, Module *mod) {
+  Snapshot_Header header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, snapshotMagic, sizeof(snapshotMagic));
+  header.formatVersion = snapshotFormatVersion;
+  header.graphVersion = graph->getGraphVersion();
+  header.moduleHash = hashFile(mod->getModuleFile());
+  header.buildFlags = getBuildFlags(graph, mod);
+  header.graphID = graph->getCurrentID();
+  /* Index LLVM instructions in module order */
+  std::unordered_map<const llvm::Instruction *, uint32_t> llvmIndex;
+  for (llvm::Function &F : *mod->getPtr()) {
+    if (mod->isFunctionSkipped(F)) {
+      continue;
+    } // End check for isFunctionSkipped
+    for (llvm::BasicBlock &BB : F) {
+      for (llvm::Instruction &I : BB) {
+        uint32_t index = llvmIndex.size();
+        llvmIndex[&I] = index;
+      } // End loop for BasicBlock
+    }   // End loop for Function
+  }     // End loop for Module
+  /* Strings are stored once and referenced by offset */
+  std::string strings;
+  std::unordered_map<std::string, uint32_t> stringOffsets;
+  auto addString = [&](const std::string &str) {
+    auto findString = stringOffsets.find(str);
+    if (findString != stringOffsets.end()) {
+      return findString->second;
+    } // End check for stored string
+    uint32_t offset = strings.size();
+    strings.append(str).push_back('\0');
+    stringOffsets.insert(std::make_pair(str, offset));
+    return offset;
+  };
+  std::vector<Snapshot_Function> functions;
+  std::vector<Snapshot_Line> lines;
+  std::vector<Snapshot_Line_Version> lineVersions;
+  std::vector<Snapshot_Instruction> instructions;
+  std::vector<Graph_Instruction *> nodes;
+  std::unordered_map<Graph_Instruction *, uint32_t> nodeIndex;
+  for (auto func : graph->getGraphFunctions()) {
+    Snapshot_Function funcRecord;
+    funcRecord.functionID = func->getFunctionID();
+    funcRecord.nameOffset = addString(func->getFunctionName());
+    funcRecord.fileOffset = addString(func->getFunctionFile());
+    funcRecord.firstLine = lines.size();
+    for (auto line : func->getFunctionLines()) {
+      Snapshot_Line lineRecord;
+      lineRecord.graphVersion = line->getLineGraphVersion();
+      lineRecord.firstVersion = lineVersions.size();
+      for (auto &lineNumber : line->getLineNumbers()) {
+        lineVersions.push_back({lineNumber.first, lineNumber.second});
+      } // End loop for lineNumbers
+      lineRecord.versionCount = lineVersions.size() - lineRecord.firstVersion;
+      lineRecord.firstInstruction = instructions.size();
+      for (auto inst : line->getLineInstructions()) {
+        Snapshot_Instruction instRecord;
+        instRecord.instructionID = inst->getInstructionID();
+        instRecord.labelOffset = addString(inst->getInstructionLabel());
+        instRecord.llvmIndex = noInstruction;
+        instRecord.rangeCount = inst->getInstructionCount();
+        if (inst->getInstructionPtr()) {
+          auto findIndex = llvmIndex.find(inst->getInstructionPtr());
+          if (findIndex == llvmIndex.end()) {
+            std::cerr << "Snapshot: instruction not found in module " << inst->getInstructionLabel() << "\n";
+            return false;
+          } // End check for findIndex
+          instRecord.llvmIndex = findIndex->second;
+        } // End check for Instruction Ptr
+        instRecord.firstEdge = 0;
+        instRecord.edgeCount = 0;
+        nodeIndex.insert(std::make_pair(inst, static_cast<uint32_t>(nodes.size())));
+        nodes.push_back(inst);
+        instructions.push_back(instRecord);
+      } // End loop for inst
+      lineRecord.instructionCount = instructions.size() - lineRecord.firstInstruction;
+      lines.push_back(lineRecord);
+    } // End loop for line
+    funcRecord.lineCount = lines.size() - funcRecord.firstLine;
+    functions.push_back(funcRecord);
+  } // End loop for func
+  std::vector<Snapshot_Edge> edges;
+  std::vector<uint32_t> edgeVersions;
+  std::unordered_map<Graph_Edge *, uint32_t> edgeIndex;
+  for (auto edge : graph->getGraphEdges()) {
+    auto findFrom = nodeIndex.find(edge->getEdgeFrom());
+    auto findTo = nodeIndex.find(edge->getEdgeTo());
+    if (findFrom == nodeIndex.end() || findTo == nodeIndex.end()) {
+      std::cerr << "Snapshot: edge ends outside the graph\n";
+      return false;
+    } // End check for edge ends
+    Snapshot_Edge edgeRecord;
+    edgeRecord.from = findFrom->second;
+    edgeRecord.to = findTo->second;
+    edgeRecord.type = edge->getEdgeType();
+    edgeRecord.firstVersion = edgeVersions.size();
+    for (auto ver : edge->getEdgeVersions()) {
+      edgeVersions.push_back(ver);
+    } // End loop for edgeVersions
+    edgeRecord.versionCount = edgeVersions.size() - edgeRecord.firstVersion;
+    edgeIndex.insert(std::make_pair(edge, static_cast<uint32_t>(edges.size())));
+    edges.push_back(edgeRecord);
+  } // End loop for edges
+  /* Edges of every node in node order. Edges that are not part of the Graph are left out */
+  std::vector<uint32_t> instructionEdges;
+  for (std::size_t index = 0; index < nodes.size(); ++index) {
+    instructions[index].firstEdge = instructionEdges.size();
+    for (auto edge : nodes[index]->getInstructionEdges()) {
+      auto findEdge = edgeIndex.find(edge);
+      if (findEdge != edgeIndex.end()) {
+        instructionEdges.push_back(findEdge->second);
+      } // End check for findEdge
+    }   // End loop for edges
+    instructions[index].edgeCount = instructionEdges.size() - instructions[index].firstEdge;
+  } // End loop for nodes
+  /* Lay out the sections after the header */
+  header.functionCount = functions.size();
+  header.lineCount = lines.size();
+  header.lineVersionCount = lineVersions.size();
+  header.instructionCount = instructions.size();
+  header.instructionEdgeCount = instructionEdges.size();
+  header.edgeCount = edges.size();
+  header.edgeVersionCount = edgeVersions.size();
+  header.stringTableSize = strings.size();
+  uint64_t offset = alignSection(sizeof(header));
+  auto placeSection = [&](uint64_t &sectionOffset, std::size_t bytes) {
+    sectionOffset = offset;
+    offset = alignSection(offset + bytes);
+  };
+  placeSection(header.functionOffset, functions.size() * sizeof(Snapshot_Function));
+  placeSection(header.lineOffset, lines.size() * sizeof(Snapshot_Line));
+  placeSection(header.lineVersionOffset, lineVersions.size() * sizeof(Snapshot_Line_Version));
+  placeSection(header.instructionOffset, instructions.size() * sizeof(Snapshot_Instruction));
+  placeSection(header.instructionEdgeOffset, instructionEdges.size() * sizeof(uint32_t));
+  placeSection(header.edgeOffset, edges.size() * sizeof(Snapshot_Edge));
+  placeSection(header.edgeVersionOffset, edgeVersions.size() * sizeof(uint32_t));
+  placeSection(header.stringTableOffset, strings.size());
+  header.fileSize = offset;
+  std::ofstream sFile(path, std::ios::binary | std::ios::trunc);
+  if (!sFile.is_open()) {
+    std::cerr << "Unable to open file for writing the snapshot\n";
+    return false;
+  } // End check for sFile
+  auto writeSection = [&](uint64_t sectionOffset, const void *data, std::size_t bytes) {
+    static const char padding[8] = {0};
+    sFile.write(padding, sectionOffset - sFile.tellp());
+    sFile.write(static_cast<const char *>(data), bytes);
+  };
+  writeSection(0, &header, sizeof(header));
+  writeSection(header.functionOffset, functions.data(), functions.size() * sizeof(Snapshot_Function));
+  writeSection(header.lineOffset, lines.data(), lines.size() * sizeof(Snapshot_Line));
+  writeSection(header.lineVersionOffset, lineVersions.data(), lineVersions.size() * sizeof(Snapshot_Line_Version));
+  writeSection(header.instructionOffset, instructions.data(), instructions.size() * sizeof(Snapshot_Instruction));
+  writeSection(header.instructionEdgeOffset, instructionEdges.data(), instructionEdges.size() * sizeof(uint32_t));
+  writeSection(header.edgeOffset, edges.data(), edges.size() * sizeof(Snapshot_Edge));
+  writeSection(header.edgeVersionOffset, edgeVersions.data(), edgeVersions.size() * sizeof(uint32_t));
+  writeSection(header.stringTableOffset, strings.data(), strings.size());
+  writeSection(header.fileSize, NULL, 0);
+  return sFile.good();
+} // End writeSnapshot
+
+bool Graph_Snapshot::openSnapshot(std::string path) {
+  closeSnapshot();
+  snapshotData = mapFile(path, snapshotSize);
+  if (!snapshotData) {
+    return false;
+  } // End check for snapshotData
+  if (!validateSnapshot()) {
+    std::cerr << "Ignoring invalid snapshot " << path << "\n";
+    closeSnapshot();
+    return false;
+  } // End check for validateSnapshot
+  return true;
+} // End openSnapshot
+
+void Graph_Snapshot::closeSnapshot() {
+  if (snapshotData) {
+    munmap(const_cast<unsigned char *>(snapshotData), snapshotSize);
+  } // End check for snapshotData
+  snapshotData = NULL;
+  snapshotSize = 0;
+} // End closeSnapshot
+
+bool Graph_Snapshot::validateSnapshot() {
+  if (snapshotSize < sizeof(Snapshot_Header)) {
+    return false;
+  } // End check for header size
+  const Snapshot_Header *header = getHeader();
+  if (std::memcmp(header->magic, snapshotMagic, sizeof(snapshotMagic)) != 0 ||
+      header->formatVersion != snapshotFormatVersion || header->fileSize != snapshotSize) {
+    return false;
+  } // End check for header
+  auto inBounds = [&](uint64_t offset, uint64_t count, uint64_t recordSize) {
+    return offset % 8 == 0 && offset <= snapshotSize && count <= (snapshotSize - offset) / recordSize;
+  };
+  if (!inBounds(header->functionOffset, header->functionCount, sizeof(Snapshot_Function)) ||
+      !inBounds(header->lineOffset, header->lineCount, sizeof(Snapshot_Line)) ||
+      !inBounds(header->lineVersionOffset, header->lineVersionCount, sizeof(Snapshot_Line_Version)) ||
+      !inBounds(header->instructionOffset, header->instructionCount, sizeof(Snapshot_Instruction)) ||
+      !inBounds(header->instructionEdgeOffset, header->instructionEdgeCount, sizeof(uint32_t)) ||
+      !inBounds(header->edgeOffset, header->edgeCount, sizeof(Snapshot_Edge)) ||
+      !inBounds(header->edgeVersionOffset, header->edgeVersionCount, sizeof(uint32_t)) ||
+      !inBounds(header->stringTableOffset, header->stringTableSize, 1)) {
+    return false;
+  } // End check for section bounds
+  if (header->stringTableSize > 0 && *getString(header->stringTableSize - 1) != '\0') {
+    return false;
+  } // End check for string table
+  auto inRange = [](uint64_t first, uint64_t count, uint64_t total) { return first <= total && count <= total - first; };
+  for (uint32_t index = 0; index < header->functionCount; ++index) {
+    const Snapshot_Function &func = getFunctions()[index];
+    if (func.nameOffset >= header->stringTableSize || func.fileOffset >= header->stringTableSize ||
+        !inRange(func.firstLine, func.lineCount, header->lineCount)) {
+      return false;
+    } // End check for func
+  }   // End loop for functions
+  for (uint32_t index = 0; index < header->lineCount; ++index) {
+    const Snapshot_Line &line = getLines()[index];
+    if (!inRange(line.firstVersion, line.versionCount, header->lineVersionCount) ||
+        !inRange(line.firstInstruction, line.instructionCount, header->instructionCount)) {
+      return false;
+    } // End check for line
+  }   // End loop for lines
+  /* Every instruction belongs to exactly one line of one function, so materializeGraph can bind all of them */
+  std::vector<char> owned(header->instructionCount, 0);
+  for (uint32_t funcIndex = 0; funcIndex < header->functionCount; ++funcIndex) {
+    const Snapshot_Function &func = getFunctions()[funcIndex];
+    for (uint32_t lineIndex = func.firstLine; lineIndex < func.firstLine + func.lineCount; ++lineIndex) {
+      const Snapshot_Line &line = getLines()[lineIndex];
+      for (uint32_t instIndex = line.firstInstruction; instIndex < line.firstInstruction + line.instructionCount;
+           ++instIndex) {
+        if (owned[instIndex]) {
+          return false;
+        } // End check for owned
+        owned[instIndex] = 1;
+      } // End loop for instructions
+    }   // End loop for lines
+  }     // End loop for functions
+  for (auto isOwned : owned) {
+    if (!isOwned) {
+      return false;
+    } // End check for isOwned
+  }   // End loop for owned
+  for (uint32_t index = 0; index < header->instructionCount; ++index) {
+    const Snapshot_Instruction &inst = getInstructions()[index];
+    if (inst.labelOffset >= header->stringTableSize || inst.rangeCount == 0 ||
+        !inRange(inst.firstEdge, inst.edgeCount, header->instructionEdgeCount)) {
+      return false;
+    } // End check for inst
+  }   // End loop for instructions
+  for (uint32_t index = 0; index < header->instructionEdgeCount; ++index) {
+    if (getInstructionEdges()[index] >= header->edgeCount) {
+      return false;
+    } // End check for edge index
+  }   // End loop for instruction edges
+  for (uint32_t index = 0; index < header->edgeCount; ++index) {
+    const Snapshot_Edge &edge = getEdges()[index];
+    if (edge.from >= header->instructionCount || edge.to >= header->instructionCount ||
+        edge.type > Graph_Edge::ANY || !inRange(edge.firstVersion, edge.versionCount, header->edgeVersionCount)) {
+      return false;
+    } // End check for edge
+  }   // End loop for edges
+  return true;
+} // End validateSnapshot
+
+bool Graph_Snapshot::isSnapshotOf(Graph *graph, Module *mod) {
+  if (!snapshotData) {
+    return false;
+  } // End check for snapshotData
+  const Snapshot_Header *header = getHeader();
+  return header->graphVersion == graph->getGraphVersion() && header->buildFlags == getBuildFlags(graph, mod) &&
+         header->moduleHash == hashFile(mod->getModuleFile());
+} // End isSnapshotOf
+
+bool Graph_Snapshot::materializeGraph(Graph *graph, Module *mod) {
+  if (!snapshotData) {
+    return false;
+  } // End check for snapshotData
+  const Snapshot_Header *header = getHeader();
+  std::vector<llvm::Instruction *> llvmInstructions;
+  for (llvm::Function &F : *mod->getPtr()) {
+    /* Load the same function bodies buildICFG would have loaded */
+    if (mod->isFunctionSkipped(F)) {
+      continue;
+    } // End check for isFunctionSkipped
+    if (!mod->materializeFunction(F)) {
+      return false;
+    } // End check for materializeFunction
+    for (llvm::BasicBlock &BB : F) {
+      for (llvm::Instruction &I : BB) {
+        llvmInstructions.push_back(&I);
+      } // End loop for BasicBlock
+    }   // End loop for Function
+  }     // End loop for Module
+  /* Check every binding before touching graph. validateSnapshot made sure every instruction is owned by a line */
+  const Snapshot_Instruction *instructions = getInstructions();
+  for (uint32_t index = 0; index < header->instructionCount; ++index) {
+    if (instructions[index].llvmIndex != noInstruction &&
+        (instructions[index].llvmIndex >= llvmInstructions.size() ||
+         instructions[index].rangeCount > llvmInstructions.size() - instructions[index].llvmIndex)) {
+      std::cerr << "Snapshot does not match the instructions of " << mod->getModuleFile() << "\n";
+      return false;
+    } // End check for llvmIndex
+  }   // End loop for instructions
+  std::vector<Graph_Instruction *> nodes(header->instructionCount, NULL);
+  const Snapshot_Line *lines = getLines();
+  const Snapshot_Line_Version *lineVersions = getLineVersions();
+  for (uint32_t funcIndex = 0; funcIndex < header->functionCount; ++funcIndex) {
+    const Snapshot_Function &funcRecord = getFunctions()[funcIndex];
+    Graph_Function *func = new Graph_Function(funcRecord.functionID);
+    func->setFunctionName(getString(funcRecord.nameOffset));
+    func->setFunctionFile(getString(funcRecord.fileOffset));
+    for (uint32_t lineIndex = funcRecord.firstLine; lineIndex < funcRecord.firstLine + funcRecord.lineCount;
+         ++lineIndex) {
+      const Snapshot_Line &lineRecord = lines[lineIndex];
+      Graph_Line *line = new Graph_Line(lineRecord.graphVersion);
+      for (uint32_t ver = lineRecord.firstVersion; ver < lineRecord.firstVersion + lineRecord.versionCount; ++ver) {
+        line->setLineNumber(lineVersions[ver].version, lineVersions[ver].lineNumber);
+      } // End loop for lineVersions
+      for (uint32_t instIndex = lineRecord.firstInstruction;
+           instIndex < lineRecord.firstInstruction + lineRecord.instructionCount; ++instIndex) {
+        const Snapshot_Instruction &instRecord = instructions[instIndex];
+        Graph_Instruction *inst = new Graph_Instruction();
+        inst->setInstructionID(instRecord.instructionID);
+        inst->setInstructionLabel(getString(instRecord.labelOffset));
+        if (instRecord.llvmIndex != noInstruction) {
+          inst->setInstructionPtr(llvmInstructions[instRecord.llvmIndex]);
+          inst->setInstructionRange(llvmInstructions[instRecord.llvmIndex + instRecord.rangeCount - 1],
+                                    instRecord.rangeCount);
+        } else {
+          inst->setInstructionPtr(NULL);
+        } // End check for llvmIndex
+        line->pushLineInstruction(inst);
+        nodes[instIndex] = inst;
+      } // End loop for instructions
+      func->pushFunctionLines(line);
+    } // End loop for lines
+    graph->pushGraphFunction(func);
+  } // End loop for functions
+  std::vector<Graph_Edge *> edges;
+  edges.reserve(header->edgeCount);
+  const uint32_t *edgeVersions = getEdgeVersions();
+  for (uint32_t edgeIndex = 0; edgeIndex < header->edgeCount; ++edgeIndex) {
+    const Snapshot_Edge &edgeRecord = getEdges()[edgeIndex];
+    Graph_Edge *edge = new Graph_Edge();
+    edge->setEdgeFrom(nodes[edgeRecord.from]);
+    edge->setEdgeTo(nodes[edgeRecord.to]);
+    edge->setEdgeType(static_cast<Graph_Edge::edgeTypes>(edgeRecord.type));
+    for (uint32_t ver = edgeRecord.firstVersion; ver < edgeRecord.firstVersion + edgeRecord.versionCount; ++ver) {
+      edge->pushEdgeVersions(edgeVersions[ver]);
+    } // End loop for edgeVersions
+    graph->pushGraphEdges(edge);
+    edges.push_back(edge);
+  } // End loop for edges
+  const uint32_t *instructionEdges = getInstructionEdges();
+  for (uint32_t instIndex = 0; instIndex < header->instructionCount; ++instIndex) {
+    const Snapshot_Instruction &instRecord = instructions[instIndex];
+    for (uint32_t ref = instRecord.firstEdge; ref < instRecord.firstEdge + instRecord.edgeCount; ++ref) {
+      nodes[instIndex]->pushEdgeInstruction(edges[instructionEdges[ref]]);
+    } // End loop for instruction edges
+  }   // End loop for instructions
+  graph->setCurrentID(header->graphID);
+  return true;
+} // End materializeGraph
+} // namespace hydrogen_framework
@@ -0,0 +1,230 @@
+/**
+ * @file
+ * Graph_Snapshot Class: Binary cache of the ICFG build step
+ */
+#ifndef GRAPH_SNAPSHOT_H
+#define GRAPH_SNAPSHOT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+namespace hydrogen_framework {
+/* Forward declaration */
+class Graph;
+class Module;
+
+/**
+ * Fixed size header at the start of a snapshot
+ * Every section is an array of the records below, starts at an 8 byte aligned offset and is referenced by index
+ */
+struct Snapshot_Header {
+  char magic[8];                  /**< Always "HYDGRAPH" */
+  uint32_t formatVersion;         /**< Layout version of the snapshot */
+  uint32_t graphVersion;          /**< Version of the Graph */
+  uint64_t moduleHash;            /**< FNV-1a hash of the LLVM IR file the Graph was built from */
+  uint32_t buildFlags;            /**< Graph settings that change the built Graph */
+  uint32_t graphID;               /**< Last ID handed out by the Graph */
+  uint32_t functionCount;         /**< Number of Snapshot_Function records */
+  uint32_t lineCount;             /**< Number of Snapshot_Line records */
+  uint32_t lineVersionCount;      /**< Number of Snapshot_Line_Version records */
+  uint32_t instructionCount;      /**< Number of Snapshot_Instruction records */
+  uint32_t instructionEdgeCount;  /**< Number of edge indices listed by instructions */
+  uint32_t edgeCount;             /**< Number of Snapshot_Edge records */
+  uint32_t edgeVersionCount;      /**< Number of edge versions */
+  uint32_t stringTableSize;       /**< Size in bytes of the string table */
+  uint64_t functionOffset;        /**< Offset of the Snapshot_Function records */
+  uint64_t lineOffset;            /**< Offset of the Snapshot_Line records */
+  uint64_t lineVersionOffset;     /**< Offset of the Snapshot_Line_Version records */
+  uint64_t instructionOffset;     /**< Offset of the Snapshot_Instruction records */
+  uint64_t instructionEdgeOffset; /**< Offset of the edge indices listed by instructions */
+  uint64_t edgeOffset;            /**< Offset of the Snapshot_Edge records */
+  uint64_t edgeVersionOffset;     /**< Offset of the edge versions */
+  uint64_t stringTableOffset;     /**< Offset of the NUL terminated strings */
+  uint64_t fileSize;              /**< Size in bytes of the whole snapshot */
+};
+
+/**
+ * Graph_Function record. Lines are consecutive Snapshot_Line records
+ */
+struct Snapshot_Function {
+  uint32_t functionID; /**< Function ID */
+  uint32_t nameOffset; /**< Function name in the string table */
+  uint32_t fileOffset; /**< Function file in the string table */
+  uint32_t firstLine;  /**< Index of the first line */
+  uint32_t lineCount;  /**< Number of lines */
+};
+
+/**
+ * Graph_Line record. Line numbers and instructions are consecutive records
+ */
+struct Snapshot_Line {
+  uint32_t graphVersion;     /**< Graph version that introduced the line */
+  uint32_t firstVersion;     /**< Index of the first Snapshot_Line_Version */
+  uint32_t versionCount;     /**< Number of line numbers */
+  uint32_t firstInstruction; /**< Index of the first instruction */
+  uint32_t instructionCount; /**< Number of instructions */
+};
+
+/**
+ * Line number of a Graph_Line in one Graph version
+ */
+struct Snapshot_Line_Version {
+  uint32_t version;    /**< Graph version */
+  uint32_t lineNumber; /**< Line number in that version */
+};
+
+/**
+ * Graph_Instruction record. Edges are consecutive indices into the Snapshot_Edge records, in the order of the node
+ */
+struct Snapshot_Instruction {
+  uint32_t instructionID; /**< Instruction ID */
+  uint32_t labelOffset;   /**< Instruction label in the string table */
+  uint32_t llvmIndex;     /**< Index of the first LLVM instruction in module order. noInstruction if virtual */
+  uint32_t rangeCount;    /**< Number of LLVM instructions covered */
+  uint32_t firstEdge;     /**< Index of the first edge index */
+  uint32_t edgeCount;     /**< Number of edges */
+};
+
+/**
+ * Graph_Edge record. Versions are consecutive entries
+ */
+struct Snapshot_Edge {
+  uint32_t from;         /**< Index of the source instruction */
+  uint32_t to;           /**< Index of the target instruction */
+  uint32_t type;         /**< Graph_Edge::edgeTypes */
+  uint32_t firstVersion; /**< Index of the first version */
+  uint32_t versionCount; /**< Number of versions */
+};
+
+/**
+ * Graph_Snapshot Class: Caches the ICFG build step. Writes a Graph into a snapshot and restores it from one
+ * The snapshot is not a zero-copy Graph. The module is still parsed and its functions materialized, because LLVM
+ * instructions are stored as their index in module order and are bound again when the Graph is restored
+ * The records are read through mmap, but the analyses work on Graph objects, so materializeGraph allocates every
+ * function, line, instruction and edge on the heap. A snapshot saves the ICFG walk and label printing, not memory
+ */
+class Graph_Snapshot {
+public:
+  /**
+   * Constructor
+   */
+  Graph_Snapshot() : snapshotData(NULL), snapshotSize(0) {}
+
+  /**
+   * Destructor
+   */
+  ~Graph_Snapshot() { closeSnapshot(); }
+
+  /**
+   * Value of llvmIndex for virtual nodes
+   */
+  static const uint32_t noInstruction = 0xFFFFFFFF;
+
+  /**
+   * Return the FNV-1a hash of the file at path. Returns zero if the file cannot be read
+   */
+  static uint64_t hashFile(std::string path);
+
+  /**
+   * Return the Graph and Module settings that are part of a snapshot
+   */
+  static uint32_t getBuildFlags(Graph *graph, Module *mod);
+
+  /**
+   * Write graph, built from mod, to a snapshot at path
+   * Returns FALSE if the file cannot be written or an edge ends outside the Graph
+   */
+  static bool writeSnapshot(std::string path, Graph *graph, Module *mod);
+
+  /**
+   * Map the snapshot at path and check its header and section bounds
+   * Returns FALSE if the file is missing or is not a valid snapshot
+   */
+  bool openSnapshot(std::string path);
+
+  /**
+   * Unmap the snapshot
+   */
+  void closeSnapshot();
+
+  /**
+   * Return true if the open snapshot was written for graph and the LLVM IR file of mod as it is now
+   */
+  bool isSnapshotOf(Graph *graph, Module *mod);
+
+  /**
+   * Fill the empty graph with heap copies of the functions, lines, instructions and edges of the open snapshot
+   * Instruction pointers are bound to the instructions of mod. Returns FALSE if they do not line up
+   */
+  bool materializeGraph(Graph *graph, Module *mod);
+
+  /**
+   * Return the header of the open snapshot
+   */
+  const Snapshot_Header *getHeader() { return reinterpret_cast<const Snapshot_Header *>(snapshotData); }
+
+  /**
+   * Return the Snapshot_Function records
+   */
+  const Snapshot_Function *getFunctions() { return getSection<Snapshot_Function>(getHeader()->functionOffset); }
+
+  /**
+   * Return the Snapshot_Line records
+   */
+  const Snapshot_Line *getLines() { return getSection<Snapshot_Line>(getHeader()->lineOffset); }
+
+  /**
+   * Return the Snapshot_Line_Version records
+   */
+  const Snapshot_Line_Version *getLineVersions() {
+    return getSection<Snapshot_Line_Version>(getHeader()->lineVersionOffset);
+  }
+
+  /**
+   * Return the Snapshot_Instruction records
+   */
+  const Snapshot_Instruction *getInstructions() {
+    return getSection<Snapshot_Instruction>(getHeader()->instructionOffset);
+  }
+
+  /**
+   * Return the edge indices listed by instructions
+   */
+  const uint32_t *getInstructionEdges() { return getSection<uint32_t>(getHeader()->instructionEdgeOffset); }
+
+  /**
+   * Return the Snapshot_Edge records
+   */
+  const Snapshot_Edge *getEdges() { return getSection<Snapshot_Edge>(getHeader()->edgeOffset); }
+
+  /**
+   * Return the edge versions
+   */
+  const uint32_t *getEdgeVersions() { return getSection<uint32_t>(getHeader()->edgeVersionOffset); }
+
+  /**
+   * Return the string at offset of the string table
+   */
+  const char *getString(uint32_t offset) {
+    return reinterpret_cast<const char *>(snapshotData + getHeader()->stringTableOffset + offset);
+  }
+
+private:
+  /**
+   * Check that every record of the open snapshot only references records and strings inside the snapshot
+   * and that every instruction is owned by exactly one line of one function
+   */
+  bool validateSnapshot();
+
+  /**
+   * Return the section at offset as an array of T
+   */
+  template <typename T> const T *getSection(uint64_t offset) {
+    return reinterpret_cast<const T *>(snapshotData + offset);
+  }
+
+  const unsigned char *snapshotData; /**< Start of the mapped snapshot. NULL if none is open */
+  std::size_t snapshotSize;          /**< Size of the mapped snapshot */
+};                                   // End Graph_Snapshot Class
+} // namespace hydrogen_framework
+#endif
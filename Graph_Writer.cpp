@@ -0,0 +1,223 @@
+/**
+ * @file
+ * Implementing Graph_Writer.hpp
+ */
+#include "Graph_Writer.hpp"
+namespace hydrogen_framework {
+/**
+ * Return the length of the well formed UTF-8 sequence starting at index of str, or zero if there is none
+ */
+static std::size_t getUTF8Length(const std::string &str, std::size_t index) {
+  unsigned char lead = str[index];
+  std::size_t length;
+  unsigned char low = 0x80;
+  unsigned char high = 0xBF;
+  if (lead >= 0xC2 && lead <= 0xDF) {
+    length = 2;
+  } else if (lead >= 0xE0 && lead <= 0xEF) {
+    length = 3;
+    /* Reject overlong forms and surrogates */
+    low = lead == 0xE0 ? 0xA0 : 0x80;
+    high = lead == 0xED ? 0x9F : 0xBF;
+  } else if (lead >= 0xF0 && lead <= 0xF4) {
+    length = 4;
+    /* Reject overlong forms and code points past U+10FFFF */
+    low = lead == 0xF0 ? 0x90 : 0x80;
+    high = lead == 0xF4 ? 0x8F : 0xBF;
+  } else {
+    return 0;
+  } // End check for lead byte
+  if (index + length > str.size()) {
+    return 0;
+  } // End check for truncated sequence
+  for (std::size_t offset = 1; offset < length; ++offset) {
+    unsigned char ch = str[index + offset];
+    if (ch < low || ch > high) {
+      return 0;
+    } // End check for continuation byte
+    low = 0x80;
+    high = 0xBF;
+  } // End loop for continuation bytes
+  return length;
+} // End getUTF8Length
+
+Graph_Writer::Graph_Writer(std::string path, bool background)
+    : writerFile(path, std::ios::trunc | std::ios::binary), writerOpen(writerFile.is_open()),
+      writerBackground(background && writerOpen), writerDone(false) {
+  writerBuffer.reserve(bufferCapacity + 4096);
+  if (writerBackground) {
+    writerPending.reserve(bufferCapacity + 4096);
+    writerThread = std::thread(&Graph_Writer::writeLoop, this);
+  } // End check for writerBackground
+} // End Graph_Writer
+
+void Graph_Writer::appendNumber(unsigned long long value) {
+  char digits[20];
+  std::size_t index = sizeof(digits);
+  do {
+    digits[--index] = static_cast<char>('0' + value % 10);
+    value /= 10;
+  } while (value);
+  append(digits + index, sizeof(digits) - index);
+} // End appendNumber
+
+void Graph_Writer::appendDOTString(const std::string &str, bool leftJustify) {
+  std::size_t start = 0;
+  for (std::size_t index = 0; index < str.size(); ++index) {
+    if (str[index] == '"') {
+      writerBuffer.append(str, start, index - start).append("\\\"");
+      start = index + 1;
+    } else if (str[index] == '\n' && leftJustify) {
+      writerBuffer.append(str, start, index - start).append("\\l");
+      start = index + 1;
+    } // End check for escaped character
+  }   // End loop for str
+  writerBuffer.append(str, start, std::string::npos);
+  if (leftJustify) {
+    writerBuffer.append("\\l");
+  } // End check for leftJustify
+  if (writerBuffer.size() >= bufferCapacity) {
+    flushBuffer();
+  } // End check for full buffer
+} // End appendDOTString
+
+void Graph_Writer::appendXMLString(const std::string &str) {
+  std::size_t start = 0;
+  for (std::size_t index = 0; index < str.size(); ++index) {
+    const char *escaped = NULL;
+    unsigned char ch = str[index];
+    switch (ch) {
+    case '&':
+      escaped = "&amp;";
+      break;
+    case '<':
+      escaped = "&lt;";
+      break;
+    case '>':
+      escaped = "&gt;";
+      break;
+    case '"':
+      escaped = "&quot;";
+      break;
+    default:
+      /* Control characters other than tab and newlines are not allowed in XML 1.0 */
+      if (ch < 0x20 && ch != '\t' && ch != '\n' && ch != '\r') {
+        escaped = " ";
+      } // End check for control character
+      break;
+    } // End switch for ch
+    if (escaped) {
+      writerBuffer.append(str, start, index - start).append(escaped);
+      start = index + 1;
+    } // End check for escaped
+  }   // End loop for str
+  writerBuffer.append(str, start, std::string::npos);
+  if (writerBuffer.size() >= bufferCapacity) {
+    flushBuffer();
+  } // End check for full buffer
+} // End appendXMLString
+
+void Graph_Writer::appendJSONString(const std::string &str) {
+  static const char hexDigits[] = "0123456789abcdef";
+  writerBuffer.push_back('"');
+  std::size_t start = 0;
+  for (std::size_t index = 0; index < str.size(); ++index) {
+    unsigned char ch = str[index];
+    if (ch != '"' && ch != '\\' && ch >= 0x20 && ch < 0x80) {
+      continue;
+    } // End check for plain character
+    if (ch >= 0x80) {
+      std::size_t length = getUTF8Length(str, index);
+      if (length) {
+        index += length - 1;
+        continue;
+      } // End check for well formed UTF-8
+    }   // End check for non ASCII byte
+    writerBuffer.append(str, start, index - start);
+    start = index + 1;
+    switch (ch) {
+    case '"':
+      writerBuffer.append("\\\"");
+      break;
+    case '\\':
+      writerBuffer.append("\\\\");
+      break;
+    case '\n':
+      writerBuffer.append("\\n");
+      break;
+    case '\t':
+      writerBuffer.append("\\t");
+      break;
+    case '\r':
+      writerBuffer.append("\\r");
+      break;
+    default:
+      /* Control characters and bytes that are not UTF-8, read as Latin-1 */
+      writerBuffer.append("\\u00");
+      writerBuffer.push_back(hexDigits[ch >> 4]);
+      writerBuffer.push_back(hexDigits[ch & 0xF]);
+      break;
+    } // End switch for ch
+  }   // End loop for str
+  writerBuffer.append(str, start, std::string::npos);
+  writerBuffer.push_back('"');
+  if (writerBuffer.size() >= bufferCapacity) {
+    flushBuffer();
+  } // End check for full buffer
+} // End appendJSONString
+
+void Graph_Writer::flushBuffer() {
+  if (!writerOpen || writerBuffer.empty()) {
+    writerBuffer.clear();
+    return;
+  } // End check for writerOpen
+  if (!writerBackground) {
+    writerFile.write(writerBuffer.data(), writerBuffer.size());
+    writerBuffer.clear();
+    return;
+  } // End check for writerBackground
+  std::unique_lock<std::mutex> lock(writerMutex);
+  writerSignal.wait(lock, [this] { return writerPending.empty(); });
+  writerPending.swap(writerBuffer);
+  writerSignal.notify_all();
+} // End flushBuffer
+
+void Graph_Writer::writeLoop() {
+  std::string writing;
+  writing.reserve(bufferCapacity + 4096);
+  std::unique_lock<std::mutex> lock(writerMutex);
+  while (true) {
+    writerSignal.wait(lock, [this] { return !writerPending.empty() || writerDone; });
+    if (writerPending.empty()) {
+      break;
+    } // End check for writerDone
+    /* Take the pending buffer and write it without holding the lock */
+    writing.swap(writerPending);
+    writerSignal.notify_all();
+    lock.unlock();
+    writerFile.write(writing.data(), writing.size());
+    writing.clear();
+    lock.lock();
+  } // End loop for pending buffers
+} // End writeLoop
+
+bool Graph_Writer::closeWriter() {
+  if (!writerOpen) {
+    return false;
+  } // End check for writerOpen
+  flushBuffer();
+  if (writerBackground) {
+    {
+      std::lock_guard<std::mutex> lock(writerMutex);
+      writerDone = true;
+    }
+    writerSignal.notify_all();
+    writerThread.join();
+    writerBackground = false;
+  } // End check for writerBackground
+  bool written = writerFile.good();
+  writerFile.close();
+  writerOpen = false;
+  return written;
+} // End closeWriter
+} // namespace hydrogen_framework
@@ -0,0 +1,114 @@
+/**
+ * @file
+ * Graph_Writer Class: Buffered output stream for graph exports
+ */
+#ifndef GRAPH_WRITER_H
+#define GRAPH_WRITER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+namespace hydrogen_framework {
+/**
+ * Graph_Writer Class: Appends output to a large reusable buffer that is written to the file in big chunks
+ * In background mode a full buffer is handed to a writer thread and filling continues in a second buffer, so
+ * formatting overlaps with file I/O. At most one buffer waits for the writer at any time
+ */
+class Graph_Writer {
+public:
+  /**
+   * Constructor
+   * Opens path for writing. Check isOpen before use
+   */
+  Graph_Writer(std::string path, bool background);
+
+  /**
+   * Destructor
+   * Calls closeWriter
+   */
+  ~Graph_Writer() { closeWriter(); }
+
+  /**
+   * Return true if the file was opened
+   */
+  bool isOpen() { return writerOpen; }
+
+  /**
+   * Append size bytes from data
+   */
+  void append(const char *data, std::size_t size) {
+    writerBuffer.append(data, size);
+    if (writerBuffer.size() >= bufferCapacity) {
+      flushBuffer();
+    } // End check for full buffer
+  }
+
+  /**
+   * Append str
+   */
+  void append(const std::string &str) { append(str.data(), str.size()); }
+
+  /**
+   * Append a string literal
+   */
+  template <std::size_t N> void append(const char (&str)[N]) { append(str, N - 1); }
+
+  /**
+   * Append the decimal digits of value
+   */
+  void appendNumber(unsigned long long value);
+
+  /**
+   * Append str as the contents of a DOT string, escaping double quotes in one pass
+   * If leftJustify is set every line ends with \l so multi-line labels are printed left justified
+   */
+  void appendDOTString(const std::string &str, bool leftJustify);
+
+  /**
+   * Append str as XML character data, escaping markup characters in one pass
+   */
+  void appendXMLString(const std::string &str);
+
+  /**
+   * Append str as a quoted JSON string, escaping in one pass
+   * Bytes that are not part of well formed UTF-8 are escaped as \u00XX so the output is always valid JSON
+   */
+  void appendJSONString(const std::string &str);
+
+  /**
+   * Write every buffered byte, stop the writer thread and close the file
+   * Returns FALSE if any write failed
+   */
+  bool closeWriter();
+
+private:
+  /**
+   * Hand the filled buffer to the file, or to the writer thread in background mode
+   */
+  void flushBuffer();
+
+  /**
+   * Body of the writer thread: write pending buffers until closed
+   */
+  void writeLoop();
+
+  /**
+   * Bytes collected before a buffer is flushed
+   */
+  static const std::size_t bufferCapacity = 1 << 20;
+
+  std::ofstream writerFile;             /**< Output file */
+  bool writerOpen;                      /**< The file is open */
+  bool writerBackground;                /**< Buffers are written on writerThread */
+  bool writerDone;                      /**< No more buffers will be handed over */
+  std::string writerBuffer;             /**< Buffer being filled */
+  std::string writerPending;            /**< Buffer waiting for writerThread */
+  std::mutex writerMutex;               /**< Guards writerPending and writerDone */
+  std::condition_variable writerSignal; /**< Signals changes of writerPending and writerDone */
+  std::thread writerThread;             /**< Background writer */
+};                                      // End Graph_Writer Class
+} // namespace hydrogen_framework
+#endif
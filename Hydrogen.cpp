@@ -2,19 +2,266 @@
  * @author Ashwin K J
  * @file
  */
+#include "Diff_Fingerprint.hpp"
 #include "Diff_Mapping.hpp"
+#include "Diff_Patch.hpp"
 #include "Get_Input.hpp"
 #include "Graph.hpp"
+#include "Graph_Edge.hpp"
+#include "Graph_Export.hpp"
 #include "Graph_Function.hpp"
 #include "Graph_Instruction.hpp"
 #include "Graph_Line.hpp"
+#include "Graph_Snapshot.hpp"
 #include "MVICFG.hpp"
 #include "Module.hpp"
 #include "Liveness.hpp"
 #include <chrono>
+#include <sstream>
+#include <thread>
 
 using namespace hydrogen_framework;
 
+/**
+ * Split a comma separated option value
+ */
+std::vector<std::string> splitOptionList(std::string value) {
+  std::vector<std::string> items;
+  std::size_t start = 0;
+  while (start <= value.size()) {
+    std::size_t end = value.find(',', start);
+    if (end == std::string::npos) {
+      end = value.size();
+    } // End check for last item
+    if (end > start) {
+      items.push_back(value.substr(start, end - start));
+    } // End check for empty item
+    start = end + 1;
+  } // End loop for value
+  return items;
+} // End splitOptionList
+
+/**
+ * Fill options from the --export-* options of framework
+ * Returns FALSE if an option value is not understood
+ */
+bool getExportOptions(Hydrogen &framework, Export_Options &options) {
+  options.exportThreads = framework.getThreadCount();
+  options.exportPerFunction = framework.hasOption("export-split");
+  if (framework.hasOption("export-format")) {
+    std::string format = framework.getOption("export-format");
+    if (format == "graphml") {
+      options.exportFormat = Export_Options::GRAPHML;
+    } else if (format == "ndjson") {
+      options.exportFormat = Export_Options::NDJSON;
+    } else if (format != "dot") {
+      std::cerr << "Unknown format " << format << " in --export-format\n";
+      return false;
+    } // End check for format
+  }   // End check for export-format option
+  for (auto &name : splitOptionList(framework.getOption("export-functions"))) {
+    options.exportFunctions.insert(name);
+  } // End loop for export-functions
+  if (framework.hasOption("export-edges")) {
+    static const std::map<std::string, Graph_Edge::edgeTypes> edgeNames = {
+        {"sequential", Graph_Edge::SEQUENTIAL}, {"branch", Graph_Edge::BRANCH},
+        {"call", Graph_Edge::CALL},             {"external", Graph_Edge::EXTERNAL_CALL},
+        {"virtual", Graph_Edge::VIRTUAL},       {"add", Graph_Edge::MVICFG_ADD},
+        {"del", Graph_Edge::MVICFG_DEL}};
+    options.exportEdgeTypes = 0;
+    for (auto &name : splitOptionList(framework.getOption("export-edges"))) {
+      auto findName = edgeNames.find(name);
+      if (findName == edgeNames.end()) {
+        std::cerr << "Unknown edge type " << name << " in --export-edges\n";
+        return false;
+      } // End check for findName
+      options.exportEdgeTypes |= 1u << findName->second;
+    } // End loop for export-edges
+  }   // End check for export-edges option
+  if (framework.hasOption("export-version")) {
+    options.exportVersion = std::atoi(framework.getOption("export-version").c_str());
+  } // End check for export-version option
+  if (framework.hasOption("export-budget")) {
+    options.exportNodeBudget = std::atoi(framework.getOption("export-budget").c_str());
+  } // End check for export-budget option
+  if (framework.hasOption("export-center")) {
+    options.exportCenter = std::atoi(framework.getOption("export-center").c_str());
+    options.exportRadius = 2;
+  } // End check for export-center option
+  if (framework.hasOption("export-radius")) {
+    options.exportRadius = std::atoi(framework.getOption("export-radius").c_str());
+  } // End check for export-radius option
+  return true;
+} // End getExportOptions
+
+/**
+ * Create an empty Graph for version with the thread and indirect call options of framework
+ */
+Graph *createGraph(Hydrogen &framework, unsigned version) {
+  Graph *graph = new Graph(version);
+  graph->setGraphThreadCount(framework.getThreadCount());
+  if (framework.hasOption("indirect-calls")) {
+    if (framework.getOption("indirect-calls") == "signature") {
+      graph->setGraphIndirectCalls(Graph::INDIRECT_SIGNATURE);
+    } else {
+      graph->setGraphIndirectCalls(Graph::INDIRECT_POINTS_TO);
+    } // End check for indirect-calls mode
+  }   // End check for indirect-calls option
+  return graph;
+} // End createGraph
+
+/**
+ * Run the liveness and dead code analyses, and the IFDS analyses with --ifds, on one version
+ * Returns the time taken in milliseconds
+ */
+long long analyzeVersion(Hydrogen &framework, Module *mod, Graph *ICFG) {
+  auto analysisStart = std::chrono::high_resolution_clock::now();
+  livenessAnalysis(mod);
+  findDeadCode(ICFG);
+  if (framework.hasOption("ifds")) {
+    ifdsAnalysis(ICFG);
+  } // End check for ifds option
+  auto analysisStop = std::chrono::high_resolution_clock::now();
+  return std::chrono::duration_cast<std::chrono::milliseconds>(analysisStop - analysisStart).count();
+} // End analyzeVersion
+
+/**
+ * Write the input arguments and summary to Result.txt
+ * Returns FALSE if the file cannot be opened
+ */
+bool writeResult(int argc, char *argv[], std::string summary) {
+  std::ofstream rFile("Result.txt", std::ios::trunc);
+  if (!rFile.is_open()) {
+    std::cerr << "Unable to open file for printing the output\n";
+    return false;
+  } // End check for Result file
+  rFile << "Input Args:\n";
+  for (auto i = 0; i < argc; ++i) {
+    rFile << argv[i] << "  ";
+  } // End loop for writing arguments
+  rFile << "\n";
+  rFile << summary;
+  rFile.close();
+  return true;
+} // End writeResult
+
+/**
+ * Build the MVICFG of every input version and export it as MVICFG
+ * The ICFG of the next version is built on a background thread while the current version is analyzed and merged.
+ * Each ICFG is released once merged
+ * Returns the exit code for main
+ */
+int buildVersions(Hydrogen &framework, const Export_Options &exportOptions, int argc, char *argv[]) {
+  std::list<Module *> moduleList = framework.getModules();
+  std::vector<Module *> modules(moduleList.begin(), moduleList.end());
+  unsigned threads = framework.getThreadCount();
+  /* Line mappings come from patches if given, otherwise from the sources of consecutive versions */
+  std::vector<std::string> patchFiles = splitOptionList(framework.getOption("patch"));
+  std::vector<std::string> revisions = splitOptionList(framework.getOption("revisions"));
+  bool fromPatches = framework.hasOption("patch");
+  bool fromGit = framework.hasOption("git-diff");
+  if (fromPatches && patchFiles.size() != modules.size() - 1) {
+    std::cerr << "--patch needs one patch for every pair of consecutive versions\n";
+    return 2;
+  } // End check for patch count
+  if (fromGit && revisions.size() != modules.size()) {
+    std::cerr << "--git-diff needs one revision for every version in --revisions\n";
+    return 2;
+  } // End check for revision count
+  std::string match = framework.hasOption("match") ? framework.getOption("match") : "text";
+  if (match != "text" && match != "fingerprint") {
+    std::cerr << "Unknown mode " << match << " in --match\n";
+    return 2;
+  } // End check for match option
+  if (framework.hasOption("block-level")) {
+    std::cerr << "--block-level is ignored since the MVICFG is built from instruction level ICFGs\n";
+  } // End check for block-level option
+  std::vector<Diff_Fingerprint> fingerprints(match == "fingerprint" ? modules.size() : 0);
+  /* The ICFG of version 1 is the MVICFG the other versions are merged into */
+  Graph *MVICFG = createGraph(framework, 1);
+  buildICFG(modules.front(), MVICFG);
+  if (!fingerprints.empty()) {
+    fingerprints.front().fingerprintModule(modules.front());
+  } // End check for fingerprints
+  /* The builder thread only touches the Module, Graph and fingerprint of the version it builds */
+  Graph *nextICFG = NULL;
+  std::thread builder;
+  auto startBuild = [&](std::size_t index) {
+    Module *mod = modules[index];
+    Graph *graph = createGraph(framework, index + 1);
+    Diff_Fingerprint *print = fingerprints.empty() ? NULL : &fingerprints[index];
+    nextICFG = graph;
+    builder = std::thread([mod, graph, print]() {
+      buildICFG(mod, graph);
+      if (print) {
+        print->fingerprintModule(mod);
+      } // End check for print
+    });
+  };
+  if (modules.size() > 1) {
+    startBuild(1);
+  } // End check for second version
+  std::ostringstream summary;
+  std::cout << "~~~~~~~~~~ Version 1: " << modules.front()->getModuleFile() << " ~~~~~~~~~~\n";
+  long long analysisTime = analyzeVersion(framework, modules.front(), MVICFG);
+  std::cout << std::endl << "Finished Analyzing version 1 in " << analysisTime << "ms\n" << std::endl;
+  summary << "Finished Analyzing version 1 in " << analysisTime << "ms\n";
+  for (std::size_t index = 1; index < modules.size(); ++index) {
+    unsigned version = index + 1;
+    builder.join();
+    Graph *ICFG = nextICFG;
+    if (index + 1 < modules.size()) {
+      startBuild(index + 1);
+    } // End check for next version
+    std::cout << "~~~~~~~~~~ Version " << version << ": " << modules[index]->getModuleFile() << " ~~~~~~~~~~\n";
+    analysisTime = analyzeVersion(framework, modules[index], ICFG);
+    auto mergeStart = std::chrono::high_resolution_clock::now();
+    std::list<Diff_Mapping> diffMap;
+    if (fromPatches || fromGit) {
+      Diff_Patch patch;
+      bool patchRead = fromPatches ? patch.readPatchFile(patchFiles[index - 1])
+                                   : patch.readGitDiff(framework.getOption("git-diff"), revisions[index - 1],
+                                                       revisions[index]);
+      if (!patchRead) {
+        /* The ICFG of the next version is freed once its builder is done with it */
+        if (builder.joinable()) {
+          builder.join();
+          nextICFG->releaseGraph();
+          delete nextICFG;
+        } // End check for running builder
+        ICFG->releaseGraph();
+        delete ICFG;
+        MVICFG->releaseGraph();
+        delete MVICFG;
+        return 4;
+      } // End check for patchRead
+      diffMap = generateLineMapping(MVICFG, patch);
+    } else if (!fingerprints.empty()) {
+      diffMap = generateLineMapping(modules[index - 1], modules[index], threads, &fingerprints[index - 1],
+                                    &fingerprints[index]);
+      fingerprints[index - 1] = Diff_Fingerprint();
+    } else {
+      diffMap = generateLineMapping(modules[index - 1], modules[index], threads);
+    } // End check for line mapping source
+    mergeICFG(MVICFG, ICFG, diffMap, version, threads);
+    ICFG->releaseGraph();
+    delete ICFG;
+    auto mergeStop = std::chrono::high_resolution_clock::now();
+    auto mergeTime = std::chrono::duration_cast<std::chrono::milliseconds>(mergeStop - mergeStart);
+    std::cout << std::endl
+              << "Finished Analyzing version " << version << " in " << analysisTime << "ms\n"
+              << "Finished Merging version " << version << " in " << mergeTime.count() << "ms\n"
+              << std::endl;
+    summary << "Finished Analyzing version " << version << " in " << analysisTime << "ms\n"
+            << "Finished Merging version " << version << " in " << mergeTime.count() << "ms\n";
+  } // End loop for versions
+  MVICFG->printGraph("MVICFG", exportOptions);
+  if (!writeResult(argc, argv, summary.str())) {
+    return 5;
+  } // End check for writeResult
+  return 0;
+} // End buildVersions
+
 /**
  * Main function
  */
@@ -26,7 +273,47 @@ int main(int argc, char *argv[]) {
               << "<Path-to-Bytecode> :: "
               << "<Path-to-file1-for-Bytecode> .. <Path-to-fileN-for-Bytecode>"
               << "\n"
-              << "Note that '::' is the demarcation\n";
+              << "Note that '::' is the demarcation\n"
+              << "Several versions build an MVICFG, with the files of each version after its own '::':\n"
+              << "<Path-to-Bytecode1> .. <Path-to-BytecodeN> :: <files-of-version1> .. :: <files-of-versionN> ..\n"
+              << "Options:\n"
+              << "  --threads[=N]  Build the ICFG on N worker threads (all hardware threads if N is omitted)\n"
+              << "                 Modules are loaded on N threads too, otherwise one thread per module\n"
+              << "  --block-level  Build one node per straight-line run of instructions instead of one per\n"
+              << "                 instruction\n"
+              << "  --indirect-calls[=signature|points-to]\n"
+              << "                 Add call edges from indirect calls to the functions they can reach instead of the\n"
+              << "                 External_Node (points-to if no mode is given)\n"
+              << "  --ifds         Also run the interprocedural liveness and uninitialized use analyses\n"
+              << "  --lazy-load    Parse the function bodies of bitcode inputs only when they are analyzed\n"
+              << "  --reachable-only[=root]\n"
+              << "                 Only load and analyze the functions reachable from root (main if omitted)\n"
+              << "  --trusted-input\n"
+              << "                 Skip the verification of the input modules\n"
+              << "  --snapshot=<path>\n"
+              << "                 Cache the ICFG build step. Load the ICFG from the snapshot at path if it was written\n"
+              << "                 for the same bytecode and options, otherwise build the ICFG and write the snapshot.\n"
+              << "                 The bytecode is still parsed and loaded in both cases\n"
+              << "Options for an MVICFG of several versions:\n"
+              << "  --match=<text|fingerprint>\n"
+              << "                 Map lines between versions by a text diff of the sources (default), or by matching\n"
+              << "                 the IR of functions and blocks and diffing only the changed ones\n"
+              << "  --patch=<p1,p2,..>\n"
+              << "                 Map lines with the unified diff pI from version I to I+1, without reading sources\n"
+              << "  --git-diff=<repository> --revisions=<r1,r2,..>\n"
+              << "                 Map lines with git diff between revision rI and rI+1 of repository\n"
+              << "  With --threads, the files of each version are also merged into the MVICFG on N workers\n"
+              << "Export options for the CFG or MVICFG:\n"
+              << "  --export-format=<dot|graphml|ndjson>\n"
+              << "                                 Write CFG.dot, CFG.graphml or CFG.ndjson (default dot)\n"
+              << "  --export-split                 Write one CFG_<functionID>.<format> per function instead\n"
+              << "  --export-functions=<f1,f2,..>  Only export the listed functions\n"
+              << "  --export-edges=<t1,t2,..>      Only export edges of the listed types: sequential, branch, call,\n"
+              << "                                 external, virtual, add, del\n"
+              << "  --export-version=<N>           Only export the nodes and edges of version N\n"
+              << "  --export-center=<ID>           Only export the neighborhood of node ID\n"
+              << "  --export-radius=<N>            Number of edges from the center in the neighborhood (default 2)\n"
+              << "  --export-budget=<N>            Stop after N nodes, keeping those closest to the center\n";
     return 1;
   } // End check for min argument
   Hydrogen framework;
@@ -36,34 +323,42 @@ int main(int argc, char *argv[]) {
   if (!framework.processInputs(argc, argv)) {
     return 3;
   } // End check for processing Inputs
+  Export_Options exportOptions;
+  if (!getExportOptions(framework, exportOptions)) {
+    return 2;
+  } // End check for export options
+  if (framework.getModules().size() > 1) {
+    return buildVersions(framework, exportOptions, argc, argv);
+  } // End check for multiple versions
   // mod is the bytecode we're making the ICFG for.
   Module *mod = framework.getModules().front();
 
   /* Create CFG */
   unsigned graphVersion = 1;
-  Graph *CFG = buildICFG(mod, graphVersion);
-  /* Start timer */
-  auto analysisStart = std::chrono::high_resolution_clock::now();
-  livenessAnalysis(mod);
-  findDeadCode(CFG);
-  /* Stop timer */
-  auto analysisStop = std::chrono::high_resolution_clock::now();
-  auto analysisTime = std::chrono::duration_cast<std::chrono::milliseconds>(analysisStop - analysisStart);
+  Graph *CFG = createGraph(framework, graphVersion);
+  if (framework.hasOption("block-level")) {
+    CFG->setGraphGranularity(Graph::BLOCK_LEVEL);
+  } // End check for block-level option
+  bool snapshotLoaded = false;
+  if (framework.hasOption("snapshot")) {
+    Graph_Snapshot snapshot;
+    if (snapshot.openSnapshot(framework.getOption("snapshot")) && snapshot.isSnapshotOf(CFG, mod)) {
+      snapshotLoaded = snapshot.materializeGraph(CFG, mod);
+    } // End check for matching snapshot
+  }   // End check for snapshot option
+  if (!snapshotLoaded) {
+    buildICFG(mod, CFG);
+    if (framework.hasOption("snapshot") && !Graph_Snapshot::writeSnapshot(framework.getOption("snapshot"), CFG, mod)) {
+      std::cerr << "Unable to write snapshot " << framework.getOption("snapshot") << "\n";
+    } // End check for writeSnapshot
+  }   // End check for snapshotLoaded
+  long long analysisTime = analyzeVersion(framework, mod, CFG);
 
-  CFG->printGraph("CFG");
-  std::cout << std::endl << "Finished Analyzing CFG in " << analysisTime.count() << "ms\n" << std::endl << std::endl;
+  CFG->printGraph("CFG", exportOptions);
+  std::cout << std::endl << "Finished Analyzing CFG in " << analysisTime << "ms\n" << std::endl << std::endl;
   /* Write output to file */
-  std::ofstream rFile("Result.txt", std::ios::trunc);
-  if (!rFile.is_open()) {
-    std::cerr << "Unable to open file for printing the output\n";
+  if (!writeResult(argc, argv, "Finished Analyzing CFG in " + std::to_string(analysisTime) + "ms\n")) {
     return 5;
-  } // End check for Result file
-  rFile << "Input Args:\n";
-  for (auto i = 0; i < argc; ++i) {
-    rFile << argv[i] << "  ";
-  } // End loop for writing arguments
-  rFile << "\n";
-  rFile << "Finished Analyzing CFG in " << analysisTime.count() << "ms\n";
-  rFile.close();
+  } // End check for writeResult
   return 0;
 } // End main
@@ -0,0 +1,130 @@
+/**
+ * @file
+ * Implementing IFDS_Solver.hpp
+ */
+#include "IFDS_Solver.hpp"
+#include "Graph.hpp"
+#include "Graph_Edge.hpp"
+#include "Graph_Function.hpp"
+#include "Graph_Instruction.hpp"
+#include "Graph_Line.hpp"
+#include <llvm/IR/CallSite.h>
+#include <llvm/IR/Instructions.h>
+namespace hydrogen_framework {
+IFDS_ICFG::IFDS_ICFG(Graph *graph, bool backward) : icfgBackward(backward) {
+  icfgUnknown.start = NULL;
+  icfgUnknown.isCall = false;
+  icfgUnknown.isEnd = false;
+  /* Find the virtual Entry and Exit of every function */
+  std::unordered_map<Graph_Instruction *, Graph_Instruction *> entryToExit;
+  std::vector<std::pair<Graph_Function *, std::pair<Graph_Instruction *, Graph_Instruction *>>> functionBounds;
+  for (auto func : graph->getGraphFunctions()) {
+    Graph_Instruction *entry = NULL;
+    Graph_Instruction *exit = NULL;
+    for (auto line : func->getFunctionLines()) {
+      for (auto inst : line->getLineInstructions()) {
+        if (inst->getInstructionPtr()) {
+          continue;
+        } // End check for virtual node
+        if (inst->getInstructionLabel().compare(0, 7, "Entry::") == 0) {
+          entry = inst;
+        } else if (inst->getInstructionLabel().compare(0, 6, "Exit::") == 0) {
+          exit = inst;
+        } // End check for virtual node kind
+      }   // End loop for inst
+    }     // End loop for line
+    if (!entry || !exit) {
+      continue;
+    } // End check for virtual nodes
+    entryToExit[entry] = exit;
+    functionBounds.push_back(std::make_pair(func, std::make_pair(entry, exit)));
+    Graph_Instruction *start = backward ? exit : entry;
+    icfgStarts.push_back(start);
+    icfgFunctionStarts.insert(std::make_pair(func->getFunctionName(), start));
+  } // End loop for func
+  /* Link every node of those functions in flow direction */
+  for (auto &bounds : functionBounds) {
+    Graph_Instruction *entry = bounds.second.first;
+    Graph_Instruction *exit = bounds.second.second;
+    for (auto line : bounds.first->getFunctionLines()) {
+      for (auto inst : line->getLineInstructions()) {
+        ICFG_Node &node = icfgNodes[inst];
+        node.start = backward ? exit : entry;
+        /* Calls to declared functions have no call edge but still bypass a callee that may use their arguments */
+        llvm::Instruction *I = inst->getLastInstructionPtr();
+        node.isCall = I && llvm::CallSite(I);
+        node.isEnd = inst == (backward ? entry : exit);
+      } // End loop for inst
+    }   // End loop for line
+  }     // End loop for functionBounds
+  auto addFlow = [&](Graph_Instruction *from, Graph_Instruction *to) {
+    if (backward) {
+      std::swap(from, to);
+    } // End check for backward
+    auto findFrom = icfgNodes.find(from);
+    if (findFrom != icfgNodes.end() && icfgNodes.find(to) != icfgNodes.end()) {
+      findFrom->second.successors.push_back(to);
+    } // End check for known nodes
+  };
+  for (auto &bounds : functionBounds) {
+    Graph_Instruction *exit = bounds.second.second;
+    for (auto line : bounds.first->getFunctionLines()) {
+      for (auto inst : line->getLineInstructions()) {
+        bool exitLinked = false;
+        for (auto edge : inst->getInstructionEdges()) {
+          if (edge->getEdgeFrom() != inst) {
+            continue;
+          } // End check for outgoing edge
+          switch (edge->getEdgeType()) {
+          case Graph_Edge::SEQUENTIAL:
+          case Graph_Edge::BRANCH:
+          case Graph_Edge::VIRTUAL:
+            exitLinked = exitLinked || edge->getEdgeTo() == exit;
+            addFlow(inst, edge->getEdgeTo());
+            break;
+          case Graph_Edge::CALL: {
+            auto findCallee = entryToExit.find(edge->getEdgeTo());
+            if (findCallee != entryToExit.end()) {
+              ICFG_Node &node = icfgNodes[inst];
+              node.isCall = true;
+              if (backward) {
+                node.callees.push_back(std::make_pair(findCallee->second, findCallee->first));
+              } else {
+                node.callees.push_back(std::make_pair(findCallee->first, findCallee->second));
+              } // End check for backward
+            }   // End check for callee Entry
+            break;
+          }
+          case Graph_Edge::EXTERNAL_CALL:
+            icfgNodes[inst].isCall = true;
+            break;
+          default:
+            break;
+          } // End switch for edge type
+        }   // End loop for edges
+        /* Only the return laid out last is linked to Exit by the Graph */
+        llvm::Instruction *I = inst->getLastInstructionPtr();
+        if (I && llvm::isa<llvm::ReturnInst>(I) && !exitLinked) {
+          addFlow(inst, exit);
+        } // End check for return
+      }   // End loop for inst
+    }     // End loop for line
+  }       // End loop for functionBounds
+} // End IFDS_ICFG constructor
+
+Graph_Instruction *IFDS_ICFG::getFunctionStart(std::string funcName) {
+  auto findStart = icfgFunctionStarts.find(funcName);
+  if (findStart == icfgFunctionStarts.end()) {
+    return NULL;
+  } // End check for findStart
+  return findStart->second;
+} // End getFunctionStart
+
+IFDS_ICFG::ICFG_Node &IFDS_ICFG::getNode(Graph_Instruction *node) {
+  auto findNode = icfgNodes.find(node);
+  if (findNode == icfgNodes.end()) {
+    return icfgUnknown;
+  } // End check for findNode
+  return findNode->second;
+} // End getNode
+} // namespace hydrogen_framework
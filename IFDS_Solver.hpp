@@ -0,0 +1,325 @@
+/**
+ * @file
+ * IFDS_Solver Class: Tabulation solver for interprocedural, finite, distributive, subset problems over the ICFG
+ */
+#ifndef IFDS_SOLVER_H
+#define IFDS_SOLVER_H
+
+#include <list>
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+namespace hydrogen_framework {
+/* Forward declaration */
+class Graph;
+class Graph_Instruction;
+
+/**
+ * IFDS_ICFG Class: View of a Graph as an ICFG in the direction an IFDS problem flows
+ * Successors follow SEQUENTIAL, BRANCH and VIRTUAL edges. Every node ending in a return also flows to the virtual
+ * Exit of its function. Call nodes have CALL or EXTERNAL_CALL edges. Their callees are the functions reached by
+ * CALL edges and their return sites are their successors.
+ * For backward problems every edge is reversed and the virtual Exit and Entry nodes trade places
+ */
+class IFDS_ICFG {
+public:
+  /**
+   * Constructor
+   */
+  IFDS_ICFG(Graph *graph, bool backward);
+
+  /**
+   * Destructor
+   */
+  ~IFDS_ICFG() { icfgNodes.clear(); }
+
+  /**
+   * Return the nodes following node within its function
+   */
+  const std::vector<Graph_Instruction *> &getSuccessors(Graph_Instruction *node) { return getNode(node).successors; }
+
+  /**
+   * Return true if node ends in a call, whether or not its callees are in the Graph
+   */
+  bool isCall(Graph_Instruction *node) { return getNode(node).isCall; }
+
+  /**
+   * Return the start and end nodes of every callee of node
+   */
+  const std::vector<std::pair<Graph_Instruction *, Graph_Instruction *>> &getCallees(Graph_Instruction *node) {
+    return getNode(node).callees;
+  }
+
+  /**
+   * Return true if node is the last node of its function in flow direction
+   */
+  bool isEnd(Graph_Instruction *node) { return getNode(node).isEnd; }
+
+  /**
+   * Return the first node in flow direction of the function containing node
+   */
+  Graph_Instruction *getStart(Graph_Instruction *node) { return getNode(node).start; }
+
+  /**
+   * Return the first node in flow direction of the function funcName. NULL if not found
+   */
+  Graph_Instruction *getFunctionStart(std::string funcName);
+
+  /**
+   * Return the first node in flow direction of every function with virtual nodes
+   */
+  std::vector<Graph_Instruction *> getFunctionStarts() { return icfgStarts; }
+
+  /**
+   * Return true if the flow runs against the edges of the Graph
+   */
+  bool isBackward() { return icfgBackward; }
+
+private:
+  /**
+   * Information on a single node in flow direction
+   */
+  struct ICFG_Node {
+    std::vector<Graph_Instruction *> successors; /**< Intraprocedural successors */
+    /** Start and end nodes of the callees */
+    std::vector<std::pair<Graph_Instruction *, Graph_Instruction *>> callees;
+    Graph_Instruction *start; /**< Start of the function */
+    bool isCall;              /**< Node ends in a call */
+    bool isEnd;               /**< Node ends the function */
+  };
+
+  /**
+   * Return the information of node. Unknown nodes have no successors
+   */
+  ICFG_Node &getNode(Graph_Instruction *node);
+
+  bool icfgBackward;                                             /**< Flow runs against the edges */
+  std::vector<Graph_Instruction *> icfgStarts;                   /**< Function starts in Graph order */
+  std::map<std::string, Graph_Instruction *> icfgFunctionStarts; /**< Function starts by name */
+  std::unordered_map<Graph_Instruction *, ICFG_Node> icfgNodes;  /**< Information of every node */
+  ICFG_Node icfgUnknown;                                         /**< Information returned for unknown nodes */
+};                                                               // End IFDS_ICFG Class
+
+/**
+ * IFDS_Problem Class: Flow functions of an IFDS problem with facts of type D
+ * D must be copyable and ordered by operator<. zeroValue is the fact that holds on every realizable path and is the
+ * source of generated facts. Facts hold before a node in flow direction
+ */
+template <typename D> class IFDS_Problem {
+public:
+  /**
+   * Destructor
+   */
+  virtual ~IFDS_Problem() {}
+
+  /**
+   * Return true if the problem flows against the edges of the Graph
+   */
+  virtual bool isBackward() { return false; }
+
+  /**
+   * Return the zero fact
+   */
+  virtual D zeroValue() = 0;
+
+  /**
+   * Return the facts holding at the start nodes the analysis begins from
+   */
+  virtual std::map<Graph_Instruction *, std::set<D>> initialSeeds(IFDS_ICFG &icfg) = 0;
+
+  /**
+   * Facts reaching succ when fact holds before curr, for nodes that do not call
+   */
+  virtual std::set<D> normalFlow(Graph_Instruction *curr, Graph_Instruction *succ, const D &fact) = 0;
+
+  /**
+   * Facts reaching the start of a callee when fact holds before callSite
+   */
+  virtual std::set<D> callFlow(Graph_Instruction *callSite, Graph_Instruction *calleeStart, const D &fact) = 0;
+
+  /**
+   * Facts reaching returnSite when fact holds at the end of the callee
+   */
+  virtual std::set<D> returnFlow(Graph_Instruction *callSite, Graph_Instruction *calleeEnd,
+                                 Graph_Instruction *returnSite, const D &fact) = 0;
+
+  /**
+   * Facts reaching returnSite alongside the call when fact holds before callSite
+   */
+  virtual std::set<D> callToReturnFlow(Graph_Instruction *callSite, Graph_Instruction *returnSite,
+                                       const D &fact) = 0;
+}; // End IFDS_Problem Class
+
+/**
+ * IFDS_Solver Class: Reps-Horwitz-Sagiv tabulation of an IFDS_Problem over a Graph
+ * Path edges are memoized per node and each callee is summarized once per entry fact, so returns only reach the
+ * return sites of the calls that led into the callee
+ */
+template <typename D> class IFDS_Solver {
+public:
+  /**
+   * Constructor
+   */
+  IFDS_Solver(Graph *graph, IFDS_Problem<D> *problem)
+      : solverICFG(graph, problem->isBackward()), solverProblem(problem) {}
+
+  /**
+   * Destructor
+   */
+  ~IFDS_Solver() {
+    solverPathEdges.clear();
+    solverEndSummaries.clear();
+    solverIncoming.clear();
+  }
+
+  /**
+   * Run the tabulation from the initial seeds of the problem until no new path edge is found
+   */
+  void solve() {
+    for (auto &seed : solverProblem->initialSeeds(solverICFG)) {
+      for (auto &fact : seed.second) {
+        propagate(fact, seed.first, fact);
+      } // End loop for seed facts
+    }   // End loop for seeds
+    while (!solverWorklist.empty()) {
+      Path_Edge edge = solverWorklist.front();
+      solverWorklist.pop_front();
+      if (solverICFG.isCall(edge.target)) {
+        processCall(edge);
+      } else if (solverICFG.isEnd(edge.target)) {
+        processEnd(edge);
+      } else {
+        processNormal(edge);
+      } // End check for node kind
+    }   // End loop for solverWorklist
+  }
+
+  /**
+   * Return the facts holding before node in flow direction
+   */
+  std::set<D> getResultsAt(Graph_Instruction *node) {
+    std::set<D> results;
+    auto findNode = solverPathEdges.find(node);
+    if (findNode != solverPathEdges.end()) {
+      for (auto &fact : findNode->second) {
+        results.insert(fact.first);
+      } // End loop for facts
+    }   // End check for findNode
+    return results;
+  }
+
+  /**
+   * Return true if node lies on a realizable path from a seed
+   */
+  bool isReachable(Graph_Instruction *node) { return solverPathEdges.find(node) != solverPathEdges.end(); }
+
+  /**
+   * Return the ICFG view the solver runs over
+   */
+  IFDS_ICFG &getICFG() { return solverICFG; }
+
+private:
+  /**
+   * Path edge from sourceFact at the start of the function of target to targetFact before target
+   */
+  struct Path_Edge {
+    D sourceFact;
+    Graph_Instruction *target;
+    D targetFact;
+  };
+
+  /**
+   * Record a path edge and queue it if it is new
+   */
+  void propagate(const D &sourceFact, Graph_Instruction *target, const D &targetFact) {
+    if (solverPathEdges[target][targetFact].insert(sourceFact).second) {
+      solverWorklist.push_back({sourceFact, target, targetFact});
+    } // End check for new path edge
+  }
+
+  /**
+   * Enter the callees of a call node and apply their summaries, then bypass the call
+   */
+  void processCall(const Path_Edge &edge) {
+    Graph_Instruction *callSite = edge.target;
+    const std::vector<Graph_Instruction *> &returnSites = solverICFG.getSuccessors(callSite);
+    for (auto &callee : solverICFG.getCallees(callSite)) {
+      for (auto &calleeFact : solverProblem->callFlow(callSite, callee.first, edge.targetFact)) {
+        solverIncoming[callee.first][calleeFact][callSite].insert(edge.targetFact);
+        propagate(calleeFact, callee.first, calleeFact);
+        /* Apply the summary of the callee if it was already computed */
+        auto &endFacts = solverEndSummaries[callee.first][calleeFact];
+        for (auto &endFact : endFacts) {
+          for (auto returnSite : returnSites) {
+            for (auto &returnFact : solverProblem->returnFlow(callSite, callee.second, returnSite, endFact)) {
+              propagate(edge.sourceFact, returnSite, returnFact);
+            } // End loop for returnFact
+          }   // End loop for returnSites
+        }     // End loop for endFacts
+      }       // End loop for calleeFact
+    }         // End loop for callees
+    for (auto returnSite : returnSites) {
+      for (auto &returnFact : solverProblem->callToReturnFlow(callSite, returnSite, edge.targetFact)) {
+        propagate(edge.sourceFact, returnSite, returnFact);
+      } // End loop for returnFact
+    }   // End loop for returnSites
+  }
+
+  /**
+   * Record a new summary of the function and return it to every call that entered with the same fact
+   */
+  void processEnd(const Path_Edge &edge) {
+    Graph_Instruction *start = solverICFG.getStart(edge.target);
+    if (!start || !solverEndSummaries[start][edge.sourceFact].insert(edge.targetFact).second) {
+      return;
+    } // End check for new end summary
+    auto findIncoming = solverIncoming.find(start);
+    if (findIncoming == solverIncoming.end()) {
+      return;
+    } // End check for callers
+    auto findFact = findIncoming->second.find(edge.sourceFact);
+    if (findFact == findIncoming->second.end()) {
+      return;
+    } // End check for callers with sourceFact
+    for (auto &caller : findFact->second) {
+      Graph_Instruction *callSite = caller.first;
+      for (auto returnSite : solverICFG.getSuccessors(callSite)) {
+        for (auto &returnFact : solverProblem->returnFlow(callSite, edge.target, returnSite, edge.targetFact)) {
+          /* Continue every path edge of the caller that reached the call with one of the incoming facts */
+          for (auto &callFact : caller.second) {
+            std::set<D> callerSources = solverPathEdges[callSite][callFact];
+            for (auto &callerSource : callerSources) {
+              propagate(callerSource, returnSite, returnFact);
+            } // End loop for callerSources
+          }   // End loop for callFact
+        }     // End loop for returnFact
+      }       // End loop for returnSites
+    }         // End loop for callers
+  }
+
+  /**
+   * Apply the normal flow function along every intraprocedural successor
+   */
+  void processNormal(const Path_Edge &edge) {
+    for (auto succ : solverICFG.getSuccessors(edge.target)) {
+      for (auto &succFact : solverProblem->normalFlow(edge.target, succ, edge.targetFact)) {
+        propagate(edge.sourceFact, succ, succFact);
+      } // End loop for succFact
+    }   // End loop for successors
+  }
+
+  IFDS_ICFG solverICFG;                /**< ICFG view in flow direction */
+  IFDS_Problem<D> *solverProblem;      /**< Problem being solved */
+  std::list<Path_Edge> solverWorklist; /**< Path edges waiting to be processed */
+  /** Path edges by target node and target fact, holding the facts at the function start */
+  std::unordered_map<Graph_Instruction *, std::map<D, std::set<D>>> solverPathEdges;
+  /** End summaries by function start and start fact, holding the facts at the function end */
+  std::unordered_map<Graph_Instruction *, std::map<D, std::set<D>>> solverEndSummaries;
+  /** Calls by callee start and start fact, holding the facts that held before the call */
+  std::unordered_map<Graph_Instruction *, std::map<D, std::map<Graph_Instruction *, std::set<D>>>> solverIncoming;
+}; // End IFDS_Solver Class
+} // namespace hydrogen_framework
+#endif
@@ -3,11 +3,15 @@
  */
 #include "Liveness.hpp"
 #include "Graph.hpp"
+#include "Graph_Chain.hpp"
 #include "Graph_Edge.hpp"
 #include "Graph_Function.hpp"
 #include "Graph_Instruction.hpp"
 #include "Graph_Line.hpp"
+#include "IFDS_Solver.hpp"
 #include "Module.hpp"
+#include <llvm/IR/Instructions.h>
+#include <unordered_set>
 
 namespace hydrogen_framework {
 
@@ -27,11 +31,44 @@ bool nodeListContains(std::list<Graph_Instruction *> &edges, Graph_Instruction *
  */
 bool isBackEdge(Graph_Edge *edge, Graph_Instruction *node) { return edge->getEdgeTo() == node; }
 
+/**
+ * An edge between the labels of two LLVM instructions.
+ */
+struct Label_Edge {
+  std::string fromLabel;
+  std::string toLabel;
+};
+
+/**
+ * Returns the edges of node as one edge per pair of adjacent LLVM instructions.
+ * For block level graphs this adds the edges inside the node, and edges to other nodes connect their last and first
+ * instructions, so label checks see the same instruction pairs as they do on an instruction level graph.
+ */
+std::list<Label_Edge> getLabelEdges(Graph *g, Graph_Instruction *node) {
+  std::list<Label_Edge> labelEdges;
+  if (g->getGraphGranularity() == Graph::INSTRUCTION_LEVEL) {
+    for (auto e : node->getInstructionEdges()) {
+      labelEdges.push_back({e->getEdgeFrom()->getInstructionLabel(), e->getEdgeTo()->getInstructionLabel()});
+    }
+    return labelEdges;
+  }
+  auto expanded = g->expandInstruction(node);
+  for (auto inst = expanded.begin(), next = std::next(inst); next != expanded.end(); ++inst, ++next) {
+    labelEdges.push_back({(*inst)->getInstructionLabel(), (*next)->getInstructionLabel()});
+  }
+  for (auto e : node->getInstructionEdges()) {
+    std::string fromLabel = g->expandInstruction(e->getEdgeFrom()).back()->getInstructionLabel();
+    std::string toLabel = g->expandInstruction(e->getEdgeTo()).front()->getInstructionLabel();
+    labelEdges.push_back({fromLabel, toLabel});
+  }
+  return labelEdges;
+}
+
 /**
  * Checks if a variable changes from its initial value before it is used.
  */
-bool checkIfVariableChanged(std::list<Graph_Instruction *> nodes_visited, std::list<Graph_Instruction *> stack,
-                            Graph_Instruction *node, std::string current_var) {
+bool checkIfVariableChanged(Graph *g, std::list<Graph_Instruction *> nodes_visited,
+                            std::list<Graph_Instruction *> stack, Graph_Instruction *node, std::string current_var) {
   int num_stores = 0;
   bool used_in_comparison = false;
   std::list<std::string> checked_instructions = {};
@@ -48,9 +85,9 @@ bool checkIfVariableChanged(std::list<Graph_Instruction *> nodes_visited, std::l
     }
 
     std::string current_var_append = current_var + ",";
-    for (auto e : edges) {
-      std::string from_label = e->getEdgeFrom()->getInstructionLabel();
-      std::string to_label = e->getEdgeTo()->getInstructionLabel();
+    for (auto e : getLabelEdges(g, node)) {
+      std::string from_label = e.fromLabel;
+      std::string to_label = e.toLabel;
 
       // Check if from_label contains the current variable
       if (from_label.find(current_var_append) != std::string::npos) {
@@ -131,53 +168,43 @@ void findDeadCode(Graph *g) {
   // Use for finding dead code in conditional statements and functions
   Graph_Instruction *node = g->findVirtualEntry("main");
   nodes_visited.push_back(node);
+  std::unordered_set<Graph_Instruction *> visited_set = {node};
   Graph_Instruction *exit_node = g->findVirtualExit("main");
 
+  // A function is used when an edge of an instruction reachable from main touches it. Reachability runs over the
+  // chain compressed graph. Edges inside a chain stay in one function, so only chain heads need their edges checked.
+  Graph_Compressed compressed(g);
+  std::unordered_set<Graph_Function *> touched_func;
+  for (auto inst : compressed.getReachableInstructions(node)) {
+    touched_func.insert(inst->getGraphLine()->getGraphFunction());
+    if (compressed.isChainHead(inst)) {
+      for (auto e : inst->getInstructionEdges()) {
+        touched_func.insert(e->getEdgeFrom()->getGraphLine()->getGraphFunction());
+      }
+    }
+  }
+  for (auto f : functions) {
+    if (touched_func.find(f) != touched_func.end()) {
+      used_func.push_back(f);
+    }
+  }
+
   std::cout << "~~~~~~~~~~ Dead Code Detection ~~~~~~~~~~" << std::endl;
   while (true) {
     auto edges = node->getInstructionEdges();
 
     for (auto e : edges) {
       if (!isBackEdge(e, node)) {
-        if (!nodeListContains(nodes_visited, e->getEdgeTo())) {
+        if (visited_set.find(e->getEdgeTo()) == visited_set.end()) {
           stack.push_back(e->getEdgeTo());
         }
       }
     }
 
-    for (auto f : functions) {
-      int func_used = 0;
-
-      // Go through all edges in instruction and check which function they are associated with, add to used function
-      // list
-      for (auto e : edges) {
-        Graph_Line *from = e->getEdgeFrom()->getGraphLine();
-        Graph_Line *to = e->getEdgeTo()->getGraphLine();
-
-        Graph_Function *func_from = from->getGraphFunction();
-        Graph_Function *func_to = to->getGraphFunction();
-
-        if (func_from == f || func_to == f) {
-          bool in_list = false;
-          for (auto u : used_func) {
-            if (u == f) {
-              in_list = true;
-            }
-          }
-
-          if (!in_list) {
-            used_func.push_back(f);
-          }
-
-          continue;
-        }
-      }
-    }
-
     // Look for variable declarations. If variable is not changed before it is used in conditional, the code in the
     // conditional is flagged as being potentially dead code.
-    for (auto e : edges) {
-      std::string from_label = e->getEdgeFrom()->getInstructionLabel();
+    for (auto e : getLabelEdges(g, node)) {
+      std::string from_label = e.fromLabel;
       std::string current_var;
 
       // Find variable being declared
@@ -194,7 +221,7 @@ void findDeadCode(Graph *g) {
 
         if (!in_list) {
           checked_variables.push_back(current_var);
-          bool changed = checkIfVariableChanged(nodes_visited, stack, node, current_var);
+          bool changed = checkIfVariableChanged(g, nodes_visited, stack, node, current_var);
 
           if (changed) {
             std::cout << "Variable " << current_var << " is changed before comparison" << std::endl;
@@ -211,6 +238,7 @@ void findDeadCode(Graph *g) {
       node = stack.front();
       stack.pop_front();
       nodes_visited.push_back(node);
+      visited_set.insert(node);
     }
   }
 
@@ -392,6 +420,10 @@ void livenessAnalysis(Module *mod) {
   std::unique_ptr<llvm::Module> &modPtr = mod->getPtr();
 
   for (llvm::Function &func : (*modPtr)) {
+    // Functions left out by --reachable-only are never loaded, others are loaded on first use
+    if (mod->isFunctionSkipped(func) || !mod->materializeFunction(func)) {
+      continue;
+    }
     // We break the module into functions, and get a list of the current function's BasicBlocks
     llvm::Function::BasicBlockListType &blocks = func.getBasicBlockList();
 
@@ -502,4 +534,337 @@ void livenessAnalysis(Module *mod) {
   }
 }
 
+/**
+ * Returns the variable inst loads from or stores to, or NULL if it does not access one.
+ * Variables are allocas and globals. retval is ignored, as it only holds a function's return value.
+ */
+const llvm::Value *getAccessedVariable(llvm::Instruction &inst, bool &isStore) {
+  const llvm::Value *ptr = NULL;
+  isStore = false;
+  if (auto load = llvm::dyn_cast<llvm::LoadInst>(&inst)) {
+    ptr = load->getPointerOperand()->stripPointerCasts();
+  } else if (auto store = llvm::dyn_cast<llvm::StoreInst>(&inst)) {
+    ptr = store->getPointerOperand()->stripPointerCasts();
+    isStore = true;
+  }
+  if (ptr == NULL || !(llvm::isa<llvm::AllocaInst>(ptr) || llvm::isa<llvm::GlobalVariable>(ptr))) {
+    return NULL;
+  }
+  if (ptr->getName().str().compare("retval") == 0) {
+    return NULL;
+  }
+  return ptr;
+}
+
+/**
+ * Returns the instructions of node, without its last instruction when skipCall is set and node ends in a call.
+ */
+std::vector<llvm::Instruction *> getNodeInstructions(Graph_Instruction *node, bool skipCall) {
+  std::vector<llvm::Instruction *> range = node->getInstructionRange();
+  if (skipCall && !range.empty() && llvm::CallSite(range.back())) {
+    range.pop_back();
+  }
+  return range;
+}
+
+/**
+ * Returns the allocas passed to inst if it is a call. The callee can read or write through them.
+ */
+std::set<const llvm::Value *> getEscapingVariables(llvm::Instruction *inst) {
+  std::set<const llvm::Value *> escaping;
+  if (auto callSite = llvm::CallSite(inst)) {
+    for (auto arg = callSite.arg_begin(); arg != callSite.arg_end(); ++arg) {
+      const llvm::Value *var = (*arg)->stripPointerCasts();
+      if (llvm::isa<llvm::AllocaInst>(var)) {
+        escaping.insert(var);
+      }
+    }
+  }
+  return escaping;
+}
+
+/**
+ * Returns the allocas passed to the call that ends node.
+ */
+std::set<const llvm::Value *> getEscapingVariables(Graph_Instruction *node) {
+  return getEscapingVariables(node->getLastInstructionPtr());
+}
+
+/**
+ * Interprocedural liveness of variables as a backward IFDS problem. A fact is a variable that may be read before it
+ * is written again. Globals flow through callees, locals bypass calls.
+ */
+class Liveness_Problem : public IFDS_Problem<const llvm::Value *> {
+public:
+  Liveness_Problem() : problemICFG(NULL) {}
+
+  bool isBackward() { return true; }
+
+  const llvm::Value *zeroValue() { return NULL; }
+
+  std::map<Graph_Instruction *, std::set<const llvm::Value *>> initialSeeds(IFDS_ICFG &icfg) {
+    problemICFG = &icfg;
+    return getMainSeeds(icfg);
+  }
+
+  std::set<const llvm::Value *> normalFlow(Graph_Instruction *curr, Graph_Instruction *succ,
+                                           const llvm::Value *const &fact) {
+    return transfer(curr, fact, false);
+  }
+
+  std::set<const llvm::Value *> callFlow(Graph_Instruction *callSite, Graph_Instruction *calleeStart,
+                                         const llvm::Value *const &fact) {
+    if (fact == NULL || llvm::isa<llvm::GlobalVariable>(fact)) {
+      return {fact};
+    }
+    return {};
+  }
+
+  std::set<const llvm::Value *> returnFlow(Graph_Instruction *callSite, Graph_Instruction *calleeEnd,
+                                           Graph_Instruction *returnSite, const llvm::Value *const &fact) {
+    if (fact == NULL || llvm::isa<llvm::GlobalVariable>(fact)) {
+      return transfer(callSite, fact, true);
+    }
+    return {};
+  }
+
+  std::set<const llvm::Value *> callToReturnFlow(Graph_Instruction *callSite, Graph_Instruction *returnSite,
+                                                 const llvm::Value *const &fact) {
+    // Globals are handled by the callees, unless the call only reaches external code
+    if (fact != NULL && llvm::isa<llvm::GlobalVariable>(fact) && !problemICFG->getCallees(callSite).empty()) {
+      return {};
+    }
+    // The callee may read the variables passed to it, so they are live at the call, before the rest of the node
+    std::set<const llvm::Value *> escaping;
+    if (fact == NULL) {
+      escaping = getEscapingVariables(callSite);
+    }
+    return transfer(callSite, fact, true, escaping);
+  }
+
+  /**
+   * Applies the instructions of node in reverse order to the facts live after it.
+   */
+  static void transferLive(Graph_Instruction *node, std::set<const llvm::Value *> &live, bool skipCall) {
+    std::vector<llvm::Instruction *> range = getNodeInstructions(node, skipCall);
+    for (auto inst = range.rbegin(); inst != range.rend(); ++inst) {
+      bool isStore;
+      const llvm::Value *var = getAccessedVariable(**inst, isStore);
+      if (var == NULL) {
+        continue;
+      }
+      if (isStore) {
+        live.erase(var);
+      } else {
+        live.insert(var);
+      }
+    }
+  }
+
+  /**
+   * Returns a seed holding the zero fact at the start of main, or at the start of every function without main.
+   */
+  static std::map<Graph_Instruction *, std::set<const llvm::Value *>> getMainSeeds(IFDS_ICFG &icfg) {
+    std::map<Graph_Instruction *, std::set<const llvm::Value *>> seeds;
+    Graph_Instruction *mainStart = icfg.getFunctionStart("main");
+    if (mainStart) {
+      seeds[mainStart].insert(NULL);
+      return seeds;
+    }
+    for (auto start : icfg.getFunctionStarts()) {
+      seeds[start].insert(NULL);
+    }
+    return seeds;
+  }
+
+private:
+  /**
+   * The zero fact generates every variable read in node, any other fact survives unless node writes it first.
+   */
+  std::set<const llvm::Value *> transfer(Graph_Instruction *node, const llvm::Value *fact, bool skipCall) {
+    return transfer(node, fact, skipCall, std::set<const llvm::Value *>());
+  }
+
+  /**
+   * Same as above, with generated also live after node.
+   */
+  std::set<const llvm::Value *> transfer(Graph_Instruction *node, const llvm::Value *fact, bool skipCall,
+                                         const std::set<const llvm::Value *> &generated) {
+    std::set<const llvm::Value *> live = generated;
+    if (fact != NULL) {
+      live.insert(fact);
+    }
+    transferLive(node, live, skipCall);
+    if (fact == NULL) {
+      live.insert(NULL);
+    } else if (live.find(fact) == live.end()) {
+      return {};
+    } else {
+      return {fact};
+    }
+    return live;
+  }
+
+  IFDS_ICFG *problemICFG;
+};
+
+/**
+ * Uses of uninitialized local variables as a forward IFDS problem. A fact is an alloca that may not have been written
+ * since it was allocated. Passing a variable to a call counts as writing it.
+ */
+class Uninitialized_Problem : public IFDS_Problem<const llvm::Value *> {
+public:
+  const llvm::Value *zeroValue() { return NULL; }
+
+  std::map<Graph_Instruction *, std::set<const llvm::Value *>> initialSeeds(IFDS_ICFG &icfg) {
+    return Liveness_Problem::getMainSeeds(icfg);
+  }
+
+  std::set<const llvm::Value *> normalFlow(Graph_Instruction *curr, Graph_Instruction *succ,
+                                           const llvm::Value *const &fact) {
+    return transfer(curr, fact, false);
+  }
+
+  std::set<const llvm::Value *> callFlow(Graph_Instruction *callSite, Graph_Instruction *calleeStart,
+                                         const llvm::Value *const &fact) {
+    if (fact == NULL) {
+      return {fact};
+    }
+    return {};
+  }
+
+  std::set<const llvm::Value *> returnFlow(Graph_Instruction *callSite, Graph_Instruction *calleeEnd,
+                                           Graph_Instruction *returnSite, const llvm::Value *const &fact) {
+    if (fact == NULL) {
+      return {fact};
+    }
+    return {};
+  }
+
+  std::set<const llvm::Value *> callToReturnFlow(Graph_Instruction *callSite, Graph_Instruction *returnSite,
+                                                 const llvm::Value *const &fact) {
+    std::set<const llvm::Value *> out = transfer(callSite, fact, true);
+    for (auto var : getEscapingVariables(callSite)) {
+      out.erase(var);
+    }
+    return out;
+  }
+
+  /**
+   * Applies the instructions of node in order to the facts uninitialized before it, collecting the variables read
+   * while uninitialized into used when it is not NULL.
+   */
+  static void transferUninitialized(Graph_Instruction *node, std::set<const llvm::Value *> &uninit, bool skipCall,
+                                    std::list<std::string> *used) {
+    for (auto inst : getNodeInstructions(node, skipCall)) {
+      if (llvm::isa<llvm::AllocaInst>(inst)) {
+        if (inst->getName().str().compare("retval") != 0) {
+          uninit.insert(inst);
+        }
+        continue;
+      }
+      bool isStore;
+      const llvm::Value *var = getAccessedVariable(*inst, isStore);
+      if (var == NULL) {
+        continue;
+      }
+      if (isStore) {
+        uninit.erase(var);
+      } else if (used != NULL && uninit.find(var) != uninit.end() &&
+                 !stringListContains(*used, var->getName().str())) {
+        used->push_back(var->getName().str());
+      }
+    }
+  }
+
+private:
+  /**
+   * The zero fact generates every variable allocated in node, any other fact survives unless node writes it.
+   */
+  std::set<const llvm::Value *> transfer(Graph_Instruction *node, const llvm::Value *fact, bool skipCall) {
+    std::set<const llvm::Value *> uninit;
+    if (fact != NULL) {
+      uninit.insert(fact);
+    }
+    transferUninitialized(node, uninit, skipCall, NULL);
+    if (fact == NULL) {
+      uninit.insert(NULL);
+    } else if (uninit.find(fact) == uninit.end()) {
+      return {};
+    } else {
+      return {fact};
+    }
+    return uninit;
+  }
+};
+
+/**
+ * Runs the interprocedural liveness and uninitialized use analyses on the ICFG g and reports, per function, the
+ * variables read before being set and the stores whose value is never read. Only paths where every return goes back
+ * to its call site are considered.
+ */
+void ifdsAnalysis(Graph *g) {
+  Liveness_Problem liveProblem;
+  IFDS_Solver<const llvm::Value *> liveSolver(g, &liveProblem);
+  liveSolver.solve();
+  Uninitialized_Problem uninitProblem;
+  IFDS_Solver<const llvm::Value *> uninitSolver(g, &uninitProblem);
+  uninitSolver.solve();
+
+  std::cout << "~~~~~~~~~~ IFDS Analysis ~~~~~~~~~~" << std::endl;
+  for (auto func : g->getGraphFunctions()) {
+    Graph_Instruction *start = uninitSolver.getICFG().getFunctionStart(func->getFunctionName());
+    if (start == NULL) {
+      continue;
+    }
+    std::cout << "~~~~~~~~~~ IFDS results for the function " << func->getFunctionName() << " ~~~~~~~~~~" << std::endl;
+    if (!uninitSolver.isReachable(start)) {
+      std::cout << "Function is not reachable from main" << std::endl;
+      continue;
+    }
+    std::list<std::string> usedUninit;
+    std::list<std::string> deadStores;
+    for (auto line : func->getFunctionLines()) {
+      for (auto inst : line->getLineInstructions()) {
+        if (uninitSolver.isReachable(inst)) {
+          std::set<const llvm::Value *> uninit = uninitSolver.getResultsAt(inst);
+          Uninitialized_Problem::transferUninitialized(inst, uninit, false, &usedUninit);
+        }
+        if (liveSolver.isReachable(inst)) {
+          // Walk backward from the facts live after inst, looking for stores to variables that are not live
+          std::set<const llvm::Value *> live = liveSolver.getResultsAt(inst);
+          std::vector<llvm::Instruction *> range = inst->getInstructionRange();
+          for (auto I = range.rbegin(); I != range.rend(); ++I) {
+            for (auto var : getEscapingVariables(*I)) {
+              live.insert(var);
+            }
+            bool isStore;
+            const llvm::Value *var = getAccessedVariable(**I, isStore);
+            if (var == NULL) {
+              continue;
+            }
+            if (isStore) {
+              if (llvm::isa<llvm::AllocaInst>(var) && live.find(var) == live.end() &&
+                  !stringListContains(deadStores, var->getName().str())) {
+                deadStores.push_back(var->getName().str());
+              }
+              live.erase(var);
+            } else {
+              live.insert(var);
+            }
+          }
+        }
+      }
+    }
+    if (usedUninit.size() > 0)
+      std::cout << "Variables possibly used without being set: {" << concatStringList(usedUninit) << "}" << std::endl;
+    if (deadStores.size() > 0)
+      std::cout << "Variables assigned a value that not used later: {" << concatStringList(deadStores) << "}"
+                << std::endl;
+    if (usedUninit.size() == 0 && deadStores.size() == 0) {
+      std::cout << "No issues found by IFDS Analysis" << std::endl;
+    }
+  }
+}
+
 } // namespace hydrogen_framework
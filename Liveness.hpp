@@ -15,6 +15,8 @@ void findDeadCode(Graph *g);
 
 void livenessAnalysis(Module *mod);
 
+void ifdsAnalysis(Graph *g);
+
 }
 
 #endif
@@ -4,158 +4,281 @@
  * Implementing MVICFG.hpp
  */
 #include "MVICFG.hpp"
+#include "Diff_Fingerprint.hpp"
 #include "Diff_Mapping.hpp"
+#include "Diff_Patch.hpp"
 #include "Graph.hpp"
 #include "Graph_Edge.hpp"
 #include "Graph_Function.hpp"
 #include "Graph_Instruction.hpp"
 #include "Graph_Line.hpp"
+#include "Match_Context.hpp"
 #include "Module.hpp"
+#include "Parallel_Util.hpp"
+#include "Source_File.hpp"
+#include <algorithm>
+#include <deque>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/Intrinsics.h>
+#include <llvm/IR/Metadata.h>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
 namespace hydrogen_framework {
 Graph *buildICFG(Module *mod, unsigned graphVersion) {
-  std::unique_ptr<llvm::Module> &modPtr = mod->getPtr();
   Graph *ICFG = new Graph(graphVersion);
-  for (llvm::Function &F : (*modPtr)) {
-    std::string funcName;
-    Graph_Function *funcGraph = new Graph_Function(ICFG->getNextID());
-    if (F.hasName()) {
-      funcName = F.getName();
-    } else {
-      funcName = "Unknown_Function";
-    } // End check for function name
-    funcGraph->setFunctionName(funcName);
-    Graph_Line *currentLineGraph = new Graph_Line(graphVersion);
-    for (llvm::BasicBlock &BB : F) {
-      for (llvm::Instruction &I : BB) {
-        unsigned int DILocLine = 0;
-        std::string DIFile = "Unknown_File";
-        getLocationInfo(I, DILocLine, DIFile);
-        /* Attach the line to current line if no debug information is found */
-        if (DILocLine == 0) {
-          DILocLine = currentLineGraph->getLineNumber(graphVersion);
-        } // End check for DILocLine
-        /* Create new Graph_Line container whenever new DILocLine is encountered */
-        if (DILocLine != currentLineGraph->getLineNumber(graphVersion)) {
-          if (!currentLineGraph->isLineInstructionEmpty()) {
-            funcGraph->pushFunctionLines(currentLineGraph);
-            ICFG->addSeqEdges(currentLineGraph);
-          } // End check for isLineInstructionEmpty
-          currentLineGraph = new Graph_Line(graphVersion);
-        } // End check for continuation for current line
-        if (!funcGraph->isFunctionFileSet()) {
-          funcGraph->setFunctionFile(DIFile);
-        } // End check for isFunctionFileSet
-        currentLineGraph->setLineNumber(graphVersion, DILocLine);
-        std::string instLabel;
-        llvm::raw_string_ostream rInstLabel(instLabel);
-        I.print(rInstLabel);
-        Graph_Instruction *currentInstGraph = new Graph_Instruction();
-        currentInstGraph->setInstructionLabel(instLabel);
-        currentInstGraph->setInstructionID(ICFG->getNextID());
-        llvm::Instruction *iTmp = &I;
-        currentInstGraph->setInstructionPtr(iTmp);
-        currentLineGraph->pushLineInstruction(currentInstGraph);
-      } // End loop for BasicBlock
-    }   // End loop for Function
-    if (!currentLineGraph->isLineInstructionEmpty()) {
-      funcGraph->pushFunctionLines(currentLineGraph);
-      ICFG->addSeqEdges(currentLineGraph);
-    } // End check for isLineInstructionEmpty
-    if (!funcGraph->isFunctionLinesEmpty()) {
-      ICFG->pushGraphFunction(funcGraph);
-      ICFG->addVirtualNodes(funcGraph);
-    } // End check for isFunctionLinesEmpty
-  }   // End loop for Module
+  return buildICFG(mod, ICFG);
+} // End buildICFG
+
+Graph *buildICFG(Module *mod, Graph *ICFG) {
+  std::unique_ptr<llvm::Module> &modPtr = mod->getPtr();
+  unsigned threads = ICFG->getGraphThreadCount();
+  if (threads > 1) {
+    /* Build every function into its own partial Graph with a private ID range */
+    /* Function bodies are materialized up front since loading is not thread safe */
+    std::vector<llvm::Function *> functions;
+    for (llvm::Function &F : (*modPtr)) {
+      if (!mod->isFunctionSkipped(F) && mod->materializeFunction(F)) {
+        functions.push_back(&F);
+      } // End check for available function
+    }   // End loop for Module
+    /* A few chunks per worker keep the load even while every chunk shares one module slot tracker */
+    std::size_t chunkCount = std::min(functions.size(), static_cast<std::size_t>(threads) * 4);
+    std::vector<Graph *> parts(functions.size());
+    parallelFor(chunkCount, threads, [&](std::size_t chunk) {
+      llvm::ModuleSlotTracker moduleSlots(modPtr.get());
+      for (std::size_t index = functions.size() * chunk / chunkCount;
+           index < functions.size() * (chunk + 1) / chunkCount; ++index) {
+        parts[index] = new Graph(ICFG->getGraphVersion());
+        parts[index]->setGraphGranularity(ICFG->getGraphGranularity());
+        buildFunctionICFG(parts[index], *functions[index], moduleSlots);
+      } // End loop for chunk
+    });
+    for (auto part : parts) {
+      ICFG->mergeGraph(part);
+      delete part;
+    } // End loop for merging parts
+  } else {
+    llvm::ModuleSlotTracker moduleSlots(modPtr.get());
+    for (llvm::Function &F : (*modPtr)) {
+      if (!mod->isFunctionSkipped(F) && mod->materializeFunction(F)) {
+        buildFunctionICFG(ICFG, F, moduleSlots);
+      } // End check for available function
+    }   // End loop for Module
+  }   // End check for threads
   ICFG->addBranchEdges();
   ICFG->addFunctionCallEdges();
   /* ICFG->printGraph("Graph_" + std::to_string(graphVersion)); */
   return ICFG;
 } // End buildICFG
 
+/**
+ * Return true if Instruction::print numbers the metadata of the whole module for I
+ * That is the case for calls to intrinsics taking an MDNode, such as llvm.dbg.declare
+ */
+static bool isReferencingMDNode(llvm::Instruction &I) {
+  llvm::CallInst *call = llvm::dyn_cast<llvm::CallInst>(&I);
+  if (!call || !call->getCalledFunction() || !call->getCalledFunction()->isIntrinsic()) {
+    return false;
+  } // End check for intrinsic call
+  for (llvm::Use &op : I.operands()) {
+    llvm::MetadataAsValue *value = llvm::dyn_cast_or_null<llvm::MetadataAsValue>(op.get());
+    if (value && llvm::isa<llvm::MDNode>(value->getMetadata())) {
+      return true;
+    } // End check for MDNode operand
+  }   // End loop for operands
+  return false;
+} // End isReferencingMDNode
+
+void buildFunctionICFG(Graph *ICFG, llvm::Function &F) {
+  llvm::ModuleSlotTracker moduleSlots(F.getParent());
+  buildFunctionICFG(ICFG, F, moduleSlots);
+} // End buildFunctionICFG
+
+void buildFunctionICFG(Graph *ICFG, llvm::Function &F, llvm::ModuleSlotTracker &moduleSlots) {
+  /* Instruction::print without a tracker numbers the slots of the module on every call */
+  /* Keep the numbering it would give: module wide for MDNode operands, else the metadata of F only */
+  llvm::ModuleSlotTracker functionSlots(F.getParent(), false);
+  unsigned graphVersion = ICFG->getGraphVersion();
+  std::string funcName;
+  Graph_Function *funcGraph = new Graph_Function(ICFG->getNextID());
+  if (F.hasName()) {
+    funcName = F.getName();
+  } else {
+    funcName = "Unknown_Function";
+  } // End check for function name
+  funcGraph->setFunctionName(funcName);
+  Graph_Line *currentLineGraph = new Graph_Line(graphVersion);
+  bool blockLevel = ICFG->getGraphGranularity() == Graph::BLOCK_LEVEL;
+  /* Block level node still open for the next instruction of the same run */
+  Graph_Instruction *currentRunGraph = NULL;
+  for (llvm::BasicBlock &BB : F) {
+    std::vector<llvm::DILocation *> blockLocations = getBlockLocationTable(BB);
+    std::size_t locationIndex = 0;
+    currentRunGraph = NULL;
+    for (llvm::Instruction &I : BB) {
+      unsigned int DILocLine = 0;
+      llvm::DILocation *DILoc = blockLocations[locationIndex++];
+      if (DILoc) {
+        DILocLine = DILoc->getLine();
+      } // End check for DILoc
+      /* Attach the line to current line if no debug information is found */
+      if (DILocLine == 0) {
+        DILocLine = currentLineGraph->getLineNumber(graphVersion);
+      } // End check for DILocLine
+      /* Create new Graph_Line container whenever new DILocLine is encountered */
+      if (DILocLine != currentLineGraph->getLineNumber(graphVersion)) {
+        if (!currentLineGraph->isLineInstructionEmpty()) {
+          funcGraph->pushFunctionLines(currentLineGraph);
+          ICFG->addSeqEdges(currentLineGraph);
+        } // End check for isLineInstructionEmpty
+        currentLineGraph = new Graph_Line(graphVersion);
+        currentRunGraph = NULL;
+      } // End check for continuation for current line
+      if (!funcGraph->isFunctionFileSet()) {
+        funcGraph->setFunctionFile(DILoc ? DILoc->getFilename().str() : "Unknown_File");
+      } // End check for isFunctionFileSet
+      currentLineGraph->setLineNumber(graphVersion, DILocLine);
+      std::string instLabel;
+      llvm::raw_string_ostream rInstLabel(instLabel);
+      I.print(rInstLabel, isReferencingMDNode(I) ? moduleSlots : functionSlots);
+      llvm::Instruction *iTmp = &I;
+      if (currentRunGraph) {
+        currentRunGraph->pushRangeInstruction(iTmp, instLabel);
+      } else {
+        Graph_Instruction *currentInstGraph = new Graph_Instruction();
+        currentInstGraph->setInstructionLabel(instLabel);
+        currentInstGraph->setInstructionID(ICFG->getNextID());
+        currentInstGraph->setInstructionPtr(iTmp);
+        currentLineGraph->pushLineInstruction(currentInstGraph);
+        if (blockLevel) {
+          currentRunGraph = currentInstGraph;
+        } // End check for blockLevel
+      }   // End check for currentRunGraph
+      /* Calls and terminators close the run so their edges leave from the end of a node */
+      /* Leaf intrinsics such as llvm.dbg.declare never get call edges, so they stay inside the run */
+      llvm::CallSite callSite(iTmp);
+      llvm::Function *callee = callSite ? callSite.getCalledFunction() : NULL;
+      bool leafIntrinsic = callee && callee->isIntrinsic() && llvm::Intrinsic::isLeaf(callee->getIntrinsicID());
+      if (I.isTerminator() || (callSite && !leafIntrinsic)) {
+        currentRunGraph = NULL;
+      } // End check for end of run
+    } // End loop for BasicBlock
+  }   // End loop for Function
+  if (!currentLineGraph->isLineInstructionEmpty()) {
+    funcGraph->pushFunctionLines(currentLineGraph);
+    ICFG->addSeqEdges(currentLineGraph);
+  } // End check for isLineInstructionEmpty
+  if (!funcGraph->isFunctionLinesEmpty()) {
+    ICFG->pushGraphFunction(funcGraph);
+    ICFG->addVirtualNodes(funcGraph);
+  } // End check for isFunctionLinesEmpty
+} // End buildFunctionICFG
+
 std::list<Diff_Mapping> generateLineMapping(Module *firstMod, Module *secondMod) {
+  return generateLineMapping(firstMod, secondMod, 1);
+} // End generateLineMapping
+
+std::list<Diff_Mapping> generateLineMapping(Module *firstMod, Module *secondMod, unsigned threadCount) {
+  return generateLineMapping(firstMod, secondMod, threadCount, NULL, NULL);
+} // End generateLineMapping
+
+std::list<Diff_Mapping> generateLineMapping(Module *firstMod, Module *secondMod, unsigned threadCount,
+                                            const Diff_Fingerprint *firstPrint, const Diff_Fingerprint *secondPrint) {
   std::list<Diff_Mapping> diffMap;
-  std::list<std::string> processedFiles;
-  /* Process files from first module */
-  for (auto iterFile : (firstMod)->getFiles()) {
-    std::list<std::string> nextModuleFiles = (secondMod)->getFiles();
-    auto fileMatch = std::find_if(std::begin(nextModuleFiles), std::end(nextModuleFiles), [=](std::string f) {
-      return (boost::filesystem::path(f).filename() == boost::filesystem::path(iterFile).filename());
-    });
-    Diff_Mapping::sequence ALines, BLines;
-    if (fileMatch != nextModuleFiles.end()) {
-      /* Matching file exist */
-      processedFiles.push_back(boost::filesystem::path(iterFile).filename().c_str());
-      std::ifstream Aifs(iterFile.c_str());
-      std::ifstream Bifs((*fileMatch).c_str());
-      Diff_Mapping::elem buf;
-      while (getline(Aifs, buf)) {
-        ALines.push_back(buf);
-      } // End loop for Aifs
-      while (getline(Bifs, buf)) {
-        BLines.push_back(buf);
-      } // End loop for Bifs
-    } else {
-      /* File no longer exist */
-      processedFiles.push_back(boost::filesystem::path(iterFile).filename().c_str());
-      std::ifstream Aifs(iterFile.c_str());
-      Diff_Mapping::elem buf;
-      while (getline(Aifs, buf)) {
-        ALines.push_back(buf);
-      } // End loop for Aifs
-    }   // End check for nextModuleFiles
-    Diff_Util diff(ALines, BLines);
-    diff.compose();
-    Diff_Ses s = diff.getSes();
-    Diff_Mapping file(boost::filesystem::path(iterFile).filename().c_str());
-    file.putMapping(s.getSequence());
-    /* file.printMapping(); */
-    diffMap.push_back(file);
+  /* First file of the next module with each file name */
+  std::unordered_map<std::string, std::string> nextModuleFiles;
+  for (auto &iterFile : secondMod->getFiles()) {
+    nextModuleFiles.insert(std::make_pair(boost::filesystem::path(iterFile).filename().string(), iterFile));
+  } // End loop for second module file indexing
+  /* Pair the files serially so the mappings keep their order */
+  std::unordered_set<std::string> processedFiles;
+  std::vector<std::pair<std::string, std::string>> filePairs;
+  for (auto &iterFile : firstMod->getFiles()) {
+    std::string fileName = boost::filesystem::path(iterFile).filename().string();
+    auto fileMatch = nextModuleFiles.find(fileName);
+    processedFiles.insert(fileName);
+    filePairs.push_back(std::make_pair(iterFile, fileMatch != nextModuleFiles.end() ? fileMatch->second : ""));
+    diffMap.push_back(Diff_Mapping(fileName));
   } // End loop for first module file processing
-  /* Check for new files in next module */
-  for (auto iterFile : (secondMod)->getFiles()) {
-    auto fileMatch = std::find_if(std::begin(processedFiles), std::end(processedFiles),
-                                  [=](std::string f) { return (f == boost::filesystem::path(iterFile).filename()); });
-    if (fileMatch == processedFiles.end()) {
+  for (auto &iterFile : secondMod->getFiles()) {
+    std::string fileName = boost::filesystem::path(iterFile).filename().string();
+    if (processedFiles.insert(fileName).second) {
       /* New file exist */
-      processedFiles.push_back(boost::filesystem::path(iterFile).filename().c_str());
-      Diff_Mapping::sequence ALines, BLines;
-      std::ifstream Bifs(iterFile.c_str());
-      Diff_Mapping::elem buf;
-      while (getline(Bifs, buf)) {
-        BLines.push_back(buf);
-      } // End loop for Bifs
-      Diff_Util diff(ALines, BLines);
-      diff.compose();
-      Diff_Ses s = diff.getSes();
-      Diff_Mapping file(boost::filesystem::path(iterFile).filename().c_str());
-      file.putMapping(s.getSequence());
-      /* file.printMapping(); */
-      diffMap.push_back(file);
+      filePairs.push_back(std::make_pair("", iterFile));
+      diffMap.push_back(Diff_Mapping(fileName));
     } // End check for processedFiles
   }   // End loop for second module file processing
+  std::vector<Diff_Mapping *> mappings;
+  for (auto &mapping : diffMap) {
+    mappings.push_back(&mapping);
+  } // End loop for diffMap
+  parallelFor(filePairs.size(), threadCount, [&](std::size_t index) {
+    /* Both versions are diffed in place in their mappings. A missing file is empty */
+    Source_File AFile, BFile;
+    if (!filePairs[index].first.empty()) {
+      AFile.openFile(filePairs[index].first);
+    } // End check for file in first module
+    if (!filePairs[index].second.empty()) {
+      BFile.openFile(filePairs[index].second);
+    } // End check for file in second module
+    if (firstPrint && secondPrint) {
+      mappings[index]->putMapping(
+          firstPrint->matchFile(*secondPrint, mappings[index]->getFileName(), AFile.getLines(), BFile.getLines()));
+      return;
+    } // End check for fingerprints
+    Diff_Util diff(AFile.getLines(), BFile.getLines());
+    diff.setDiffMode(Diff_Util::DIFF_HASHED);
+    diff.composeAnchored(1);
+    mappings[index]->putMapping(diff.getEditScript());
+  });
+  return diffMap;
+} // End generateLineMapping
+
+std::list<Diff_Mapping> generateLineMapping(Graph *ICFG, const Diff_Patch &patch) {
+  std::list<Diff_Mapping> diffMap;
+  /* The last line the ICFG knows of stands in for the length of each file */
+  std::map<std::string, long long> lastLines;
+  for (auto func : ICFG->getGraphFunctions()) {
+    long long &lastLine = lastLines[boost::filesystem::path(func->getFunctionFile()).filename().string()];
+    for (auto line : func->getFunctionLines()) {
+      long long lineNo = line->getLineNumber(ICFG->getGraphVersion());
+      if (!ICFG->isVirtualNodeLineNumber(lineNo) && lineNo > lastLine) {
+        lastLine = lineNo;
+      } // End check for lineNo
+    }   // End loop for function lines
+  }     // End loop for functions
+  std::set<std::string> patchedFiles;
+  for (auto &file : patch.getPatchFiles()) {
+    std::string fileName = Diff_Patch::getFileName(file);
+    if (!patchedFiles.insert(fileName).second) {
+      continue;
+    } // End check for patchedFiles
+    auto findLast = lastLines.find(fileName);
+    diffMap.push_back(Diff_Mapping(fileName));
+    diffMap.back().putMapping(Diff_Patch::getEditScript(file, findLast != lastLines.end() ? findLast->second : 0));
+  } // End loop for patch files
+  for (auto &last : lastLines) {
+    if (patchedFiles.count(last.first) || last.second == 0) {
+      continue;
+    } // End check for changed file
+    /* Unchanged file maps every line to itself */
+    Diff_Vars::editScript script(1);
+    script[0].type = Diff_Vars::SES_COMMON;
+    script[0].beforeIdx = 1;
+    script[0].afterIdx = 1;
+    script[0].count = last.second;
+    diffMap.push_back(Diff_Mapping(last.first));
+    diffMap.back().putMapping(script);
+  } // End loop for unchanged files
   return diffMap;
 } // End generateLineMapping
 
 std::list<Graph_Line *> getGraphLinesGivenLine(Graph *graph, long long lineNo, std::string fileName) {
-  std::list<Graph_Line *> graphLines;
-  bool foundLine = false;
-  for (auto func : graph->getGraphFunctions()) {
-    /* Matching with correct diff File */
-    if (func->getFunctionFile() == fileName) {
-      for (auto line : func->getFunctionLines()) {
-        /* Matching line of diff */
-        if (line->getLineNumber(graph->getGraphVersion()) == lineNo) {
-          graphLines.push_back(line);
-          foundLine = true;
-        } // End check for lineNo
-      }   // End loop for line
-      /* Same line cannot be spread across functions. Hence stop search if at least one line found */
-      if (foundLine) {
-        return graphLines;
-      } // End check for foundLine
-    }   // End check for fileName
-  }     // End loop for Functions
-  return graphLines;
+  if (lineNo < 0 || lineNo > std::numeric_limits<unsigned>::max()) {
+    return std::list<Graph_Line *>();
+  } // End check for lineNo range
+  return graph->getIndexedLines(graph->getGraphVersion(), fileName, lineNo);
 } // End getGraphLinesGivenLine
 
 std::list<Graph_Line *> getPredGivenGraphLine(Graph_Line *line) {
@@ -187,9 +310,9 @@ std::string getGraphLineInstructionsAsString(Graph_Line *line) {
   /* Iterate through the Graph_Line and make a string representation of the Instruction OpCode */
   for (auto inst : line->getLineInstructions()) {
     /* If Ptr is not found, then it won't be present in the other version as well */
-    if (inst->getInstructionPtr() != NULL) {
-      lineString.append(inst->getInstructionPtr()->getOpcodeName()).append(" ");
-    } // End check for Instruction Ptr
+    for (auto I : inst->getInstructionRange()) {
+      lineString.append(I->getOpcodeName()).append(" ");
+    } // End loop for Instruction range
   }   // End loop for Graph_Line
   if (!lineString.empty()) {
     lineString.pop_back();
@@ -198,7 +321,7 @@ std::string getGraphLineInstructionsAsString(Graph_Line *line) {
 } // End getGraphLineInstructionsAsString
 
 Graph_Line *resolveMatchedLinesWithNoExtactStringMatch(std::list<Graph_Line *> matchedLines, std::string lineFromString,
-                                                       unsigned int graphVersion) {
+                                                       unsigned int graphVersion, std::ostream &errors) {
   int minDiff = std::numeric_limits<int>::max();
   Graph_Line *tmp = NULL;
   for (auto line : matchedLines) {
@@ -225,17 +348,19 @@ Graph_Line *resolveMatchedLinesWithNoExtactStringMatch(std::list<Graph_Line *> m
     } // End check to update minDiff
   }   // End loop for matchedLines
   if (minDiff > 2) {
-    std::cerr << "The heuristically matched line for " << tmp->getLineNumber(graphVersion) << "might be incorrect\n";
+    errors << "The heuristically matched line for " << tmp->getLineNumber(graphVersion) << "might be incorrect\n";
   } // End check for minDiff
   return tmp;
 } // End resolveMatchedLinesWithNoExtactStringMatch
 
-Graph_Line *findMatchedLine(Graph_Line *t, Graph *matchTo, Graph *matchFrom, Diff_Mapping diff) {
+Graph_Line *findMatchedLine(Graph_Line *t, Graph *matchTo, Graph *matchFrom, Match_Context &context) {
+  const Diff_Mapping &diff = context.getDiff();
+  std::ostream &errors = context.getErrors();
   /* Extra check to ensure correct diff File */
   if (diff.getFileName() != t->getGraphFunction()->getFunctionFile()) {
-    std::cerr << "findMatchedLine is using wrong diff File\n";
-    std::cerr << "Skipping match for " << t->getLineNumber(matchFrom->getGraphVersion()) << " from "
-              << matchFrom->getGraphVersion() << " to " << matchTo->getGraphVersion() << "\n";
+    errors << "findMatchedLine is using wrong diff File\n";
+    errors << "Skipping match for " << t->getLineNumber(matchFrom->getGraphVersion()) << " from "
+           << matchFrom->getGraphVersion() << " to " << matchTo->getGraphVersion() << "\n";
     return NULL;
   } // End check for diff File name
   unsigned lineFrom = t->getLineNumber(matchFrom->getGraphVersion());
@@ -264,36 +389,29 @@ Graph_Line *findMatchedLine(Graph_Line *t, Graph *matchTo, Graph *matchFrom, Dif
     }   // End check for matchTo > matchFrom
   }     // End check for isVirtualNodeLineNumber
   if (lineTo != std::numeric_limits<unsigned>::max()) {
-    for (auto func : matchTo->getGraphFunctions()) {
-      if (func->getFunctionFile() == t->getGraphFunction()->getFunctionFile()) {
-        if (func->getFunctionName() == t->getGraphFunction()->getFunctionName()) {
-          std::list<Graph_Line *> matchedLines;
-          for (auto line : func->getFunctionLines()) {
-            if (lineTo == line->getLineNumber(matchTo->getGraphVersion())) {
-              std::string lineToString = getGraphLineInstructionsAsString(line);
-              std::string lineFromString = getGraphLineInstructionsAsString(t);
-              if (lineToString == lineFromString) {
-                return line;
-              } else {
-                matchedLines.push_back(line);
-              } // End check for lineTo and lineFrom string
-            }   // End check for matching line number
-          }     // End loop for lines
-          /* If there is a match at this point heuristically match it rather than return NULL */
-          if (!matchedLines.empty()) {
-            /* If only one match is there, then we don't have to work much */
-            if (matchedLines.size() == 1) {
-              return matchedLines.front();
-            } else {
-              std::string lineFromString = getGraphLineInstructionsAsString(t);
-              return resolveMatchedLinesWithNoExtactStringMatch(matchedLines, lineFromString,
-                                                                matchTo->getGraphVersion());
-            } // End check for matchedLines size
-          }   // End check for empty matchedLines
-        }     // End check for Function name check
-      }       // End check for File name
-    }         // End loop for functions
-  }           // End check for virtual node check
+    /* Lines numbered lineTo in the first function of the same file and name */
+    Graph_Function *tFunc = t->getGraphFunction();
+    std::list<Graph_Line *> matchedLines = matchTo->getIndexedLines(
+        matchTo->getGraphVersion(), tFunc->getFunctionFile(), lineTo, tFunc->getFunctionName());
+    /* Same opcodes in the same order is the same string from getGraphLineInstructionsAsString */
+    const std::vector<unsigned> &lineFromOpcodes = context.getLineOpcodes(t);
+    for (auto line : matchedLines) {
+      if (context.getLineOpcodes(line) == lineFromOpcodes) {
+        return line;
+      } // End check for lineTo and lineFrom opcodes
+    }   // End loop for lines
+    /* If there is a match at this point heuristically match it rather than return NULL */
+    if (!matchedLines.empty()) {
+      /* If only one match is there, then we don't have to work much */
+      if (matchedLines.size() == 1) {
+        return matchedLines.front();
+      } else {
+        std::string lineFromString = getGraphLineInstructionsAsString(t);
+        return resolveMatchedLinesWithNoExtactStringMatch(matchedLines, lineFromString, matchTo->getGraphVersion(),
+                                                          errors);
+      } // End check for matchedLines size
+    }   // End check for empty matchedLines
+  }     // End check for virtual node check
   return NULL;
 } // End findMatchedLine
 
@@ -327,37 +445,33 @@ Graph_Edge *getInBetweenEdge(Graph_Line *fromLine, Graph_Line *toLine) {
   return NULL;
 } // End getInBetweenEdge
 
-Graph_Line *getNewlyAdded(Graph *MVICFG, Graph *ICFG, Graph_Line *newLine, Diff_Mapping diff) {
-  std::list<long long> addedLines = diff.getAddedLines();
-  auto findAdd = std::find_if(std::begin(addedLines), std::end(addedLines),
-                              [=](long long no) { return (no == newLine->getLineNumber(ICFG->getGraphVersion())); });
-  if (findAdd != addedLines.end()) {
-    for (auto func : MVICFG->getGraphFunctions()) {
-      /* Compare line number within same file */
-      if (func->getFunctionFile() == newLine->getGraphFunction()->getFunctionFile()) {
-        for (auto line : func->getFunctionLines()) {
-          if (newLine->getLineNumber(ICFG->getGraphVersion()) == line->getLineNumber(ICFG->getGraphVersion())) {
-            return line;
-          } // End check for line and newLine numbers
-        }   // End loop for line
-      }     // End check for function file
-    }       // End loop for function
-  }         // End check for addLines.end
+Graph_Line *getNewlyAdded(Graph *MVICFG, Graph *ICFG, Graph_Line *newLine, const Diff_Mapping &diff) {
+  unsigned newLineNumber = newLine->getLineNumber(ICFG->getGraphVersion());
+  if (diff.isAddedLine(newLineNumber)) {
+    /* Compare line number within same file */
+    std::list<Graph_Line *> lines =
+        MVICFG->getIndexedLines(ICFG->getGraphVersion(), newLine->getGraphFunction()->getFunctionFile(), newLineNumber);
+    if (!lines.empty()) {
+      return lines.front();
+    } // End check for lines
+  }   // End check for addLines.end
   return NULL;
 } // End getNewlyAdded
 
-std::list<Graph_Line *> addToMVICFG(Graph *MVICFG, Graph *ICFG, Diff_Mapping diff, unsigned Version) {
-  std::list<long long> addedLines = diff.getAddedLines();
+std::list<Graph_Line *> addNodesToMVICFG(Graph *MVICFG, Graph *ICFG, Match_Context &context, unsigned Version,
+                                         std::list<Graph_Line *> &icfgN) {
+  const Diff_Mapping &diff = context.getDiff();
+  std::ostream &errors = context.getErrors();
+  const std::vector<long long> &addedLines = diff.getAddedLines();
   std::string fileName = diff.getFileName();
   std::list<Graph_Line *> N;
-  std::list<Graph_Line *> icfgN;
   /*Identify all added lines */
   for (auto line : addedLines) {
     std::list<Graph_Line *> addedGraphLines;
     addedGraphLines = getGraphLinesGivenLine(ICFG, line, fileName);
     if (addedGraphLines.empty()) {
-      std::cerr << "Graph_Line for line " << line << ":" << fileName << " not found in ICFG Ver " << Version << "\n";
-      std::cerr << "Skipping this line and continuing\n";
+      errors << "Graph_Line for line " << line << ":" << fileName << " not found in ICFG Ver " << Version << "\n";
+      errors << "Skipping this line and continuing\n";
       continue;
     } // End check for addedGraphLines
     for (auto addedLine : addedGraphLines) {
@@ -366,15 +480,16 @@ std::list<Graph_Line *> addToMVICFG(Graph *MVICFG, Graph *ICFG, Diff_Mapping dif
       std::list<Graph_Function *> mvicfgFunctions = MVICFG->getGraphFunctions();
       auto findMvicfgFunc =
           std::find_if(std::begin(mvicfgFunctions), std::end(mvicfgFunctions), [=](Graph_Function *mvicfgfunc) {
-            return mvicfgfunc->getFunctionName() == func->getFunctionName();
+            return mvicfgfunc->getFunctionName() == func->getFunctionName() &&
+                   mvicfgfunc->getFunctionFile() == func->getFunctionFile();
           });
       /* Create new one if it doesn't exist */
       Graph_Function *mvicfgFunc;
       if (findMvicfgFunc == mvicfgFunctions.end()) {
         mvicfgFunc = new Graph_Function(MVICFG->getNextID());
-        Graph_Function *mvicfgFunc = new Graph_Function(MVICFG->getNextID());
         mvicfgFunc->setFunctionName(func->getFunctionName());
         mvicfgFunc->setFunctionFile(func->getFunctionFile());
+        MVICFG->pushGraphFunction(mvicfgFunc);
       } else {
         mvicfgFunc = *findMvicfgFunc;
       } // End check for findMvicfgFunc
@@ -394,13 +509,20 @@ std::list<Graph_Line *> addToMVICFG(Graph *MVICFG, Graph *ICFG, Diff_Mapping dif
       icfgN.push_back(addedLine);
     } // End loop for processing addedGraphLines
   }   // End loop for identifying added lines
+  return N;
+} // End addNodesToMVICFG
+
+void addEdgesForAddedNodes(Graph *MVICFG, Graph *ICFG, Match_Context &context, const std::list<Graph_Line *> &N,
+                           const std::list<Graph_Line *> &icfgN, unsigned Version) {
+  std::ostream &errors = context.getErrors();
+  std::string fileName = context.getDiff().getFileName();
   for (auto n : N) {
     /* Proceed only if the function is in diff File being processed */
     if (n->getGraphFunction()->getFunctionFile() == fileName) {
-      Graph_Line *nDash = findMatchedLine(n, ICFG, MVICFG, diff);
+      Graph_Line *nDash = findMatchedLine(n, ICFG, MVICFG, context);
       if (!nDash) {
-        std::cerr << "ICFG line corresponding to the added MVICFG line " << n->getLineNumber(ICFG->getGraphVersion())
-                  << " not found\n";
+        errors << "ICFG line corresponding to the added MVICFG line " << n->getLineNumber(ICFG->getGraphVersion())
+               << " not found\n";
         continue;
       } // End check for nDash
       std::list<Graph_Line *> pred = getPredGivenGraphLine(nDash);
@@ -414,7 +536,7 @@ std::list<Graph_Line *> addToMVICFG(Graph *MVICFG, Graph *ICFG, Diff_Mapping dif
           /* t in T but not in N */
           /* Proceed only if the function is in diff File being processed */
           if (t->getGraphFunction()->getFunctionFile() == fileName) {
-            Graph_Line *tDash = findMatchedLine(t, MVICFG, ICFG, diff);
+            Graph_Line *tDash = findMatchedLine(t, MVICFG, ICFG, context);
             if (tDash) {
               auto findTPred = std::find_if(std::begin(pred), std::end(pred), [=](Graph_Line *N) { return (N == t); });
               auto findTSucc = std::find_if(std::begin(succ), std::end(succ), [=](Graph_Line *N) { return (N == t); });
@@ -439,14 +561,14 @@ std::list<Graph_Line *> addToMVICFG(Graph *MVICFG, Graph *ICFG, Diff_Mapping dif
                       edgeType = checkBetweenEdge->getEdgeType();
                     } // End check for checkBetweenEdge
                     if (!foundEdge) {
-                      std::cerr << "ICFG edge between " << tInst->getInstructionLabel() << " and "
-                                << nDashInst->getInstructionLabel() << " not found\n";
-                      std::cerr << "Setting edge type to MVICFG_ADD\n";
+                      errors << "ICFG edge between " << tInst->getInstructionLabel() << " and "
+                             << nDashInst->getInstructionLabel() << " not found\n";
+                      errors << "Setting edge type to MVICFG_ADD\n";
                       edgeType = Graph_Edge::MVICFG_ADD;
                     } // End check for foundEdge
                   }   // End check for getEdgeType
                   Graph_Edge *newEdge = new Graph_Edge(tDashInst, nInst, edgeType, Version);
-                  MVICFG->addEdge(tDashInst, nInst, newEdge);
+                  context.addEdge(tDashInst, nInst, newEdge);
                 } else {
                   checkEdge->pushEdgeVersions(Version);
                 } // End check for checkEdge
@@ -471,27 +593,32 @@ std::list<Graph_Line *> addToMVICFG(Graph *MVICFG, Graph *ICFG, Diff_Mapping dif
                       edgeType = checkBetweenEdge->getEdgeType();
                     } // End check for checkBetweenEdge
                     if (!foundEdge) {
-                      std::cerr << "ICFG edge between " << tInst->getInstructionLabel() << " and "
-                                << nDashInst->getInstructionLabel() << " not found\n";
-                      std::cerr << "Setting edge type to MVICFG_ADD\n";
+                      errors << "ICFG edge between " << tInst->getInstructionLabel() << " and "
+                             << nDashInst->getInstructionLabel() << " not found\n";
+                      errors << "Setting edge type to MVICFG_ADD\n";
                       edgeType = Graph_Edge::MVICFG_ADD;
                     } // End check for foundEdge
                   }   // End check for edgeType
                   Graph_Edge *newEdge = new Graph_Edge(nInst, tDashInst, edgeType, Version);
-                  MVICFG->addEdge(nInst, tDashInst, newEdge);
+                  context.addEdge(nInst, tDashInst, newEdge);
                 } else {
                   checkEdge->pushEdgeVersions(Version);
                 } // End check for checkEdge
               }   // End check for Predecessor & Successors
             } else {
-              std::cerr << "No matching line found for " << t->getLineNumber(ICFG->getGraphVersion())
-                        << " in MVICFG(A)\n";
+              errors << "No matching line found for " << t->getLineNumber(ICFG->getGraphVersion()) << " in MVICFG(A)\n";
             } // End check for tDash
           }   // End check to see if the function is in the same diff file
         }     // End check for find T
       }       // End loop for T
     }         // End check to see if the function is in the same diff file
   }           // End loop for adding edges for added lines
+} // End addEdgesForAddedNodes
+
+std::list<Graph_Line *> addToMVICFG(Graph *MVICFG, Graph *ICFG, Match_Context &context, unsigned Version) {
+  std::list<Graph_Line *> icfgN;
+  std::list<Graph_Line *> N = addNodesToMVICFG(MVICFG, ICFG, context, Version, icfgN);
+  addEdgesForAddedNodes(MVICFG, ICFG, context, N, icfgN, Version);
   /* Return the added lines */
   return N;
 } // End addToMVICFG
@@ -520,11 +647,34 @@ Graph_Instruction *getMatchedInstructionFromGraph(Graph *graphToMatch, Graph_Ins
   return NULL;
 } // End getMatchedInstructionFromGraph
 
-void getEdgesForAddedLines(Graph *MVICFG, Graph *ICFG, std::list<Graph_Line *> addedLines,
-                           std::list<Diff_Mapping> diffMap, unsigned Version) {
+std::unordered_map<llvm::Instruction *, Graph_Instruction *> getInstructionIndex(Graph *graph) {
+  std::unordered_map<llvm::Instruction *, Graph_Instruction *> instructionIndex;
+  for (auto func : graph->getGraphFunctions()) {
+    for (auto line : func->getFunctionLines()) {
+      for (auto inst : line->getLineInstructions()) {
+        if (inst->getInstructionPtr()) {
+          /* Keeps the first Graph_Instruction for a PTR */
+          instructionIndex.insert(std::make_pair(inst->getInstructionPtr(), inst));
+        } // End check for Instruction Ptr
+      }   // End loop for inst
+    }     // End loop for line
+  }       // End loop for func
+  return instructionIndex;
+} // End getInstructionIndex
+
+void getEdgesForAddedLines(Graph *MVICFG, Graph *ICFG, const std::list<Graph_Line *> &addedLines) {
+  /* Only edges are added here, so the instructions of both graphs are indexed once up front */
+  std::unordered_map<llvm::Instruction *, Graph_Instruction *> icfgInstructions = getInstructionIndex(ICFG);
+  std::unordered_map<llvm::Instruction *, Graph_Instruction *> mvicfgInstructions = getInstructionIndex(MVICFG);
+  /* Virtual nodes have no PTR and get no match, as in getMatchedInstructionFromGraph */
+  auto getMatchedInstruction = [](std::unordered_map<llvm::Instruction *, Graph_Instruction *> &instructionIndex,
+                                  Graph_Instruction *instToMatch) -> Graph_Instruction * {
+    auto findInst = instructionIndex.find(instToMatch->getInstructionPtr());
+    return findInst != instructionIndex.end() ? findInst->second : NULL;
+  };
   for (auto line : addedLines) {
     for (auto lineInst : line->getLineInstructions()) {
-      Graph_Instruction *lineDashInst = getMatchedInstructionFromGraph(ICFG, lineInst);
+      Graph_Instruction *lineDashInst = getMatchedInstruction(icfgInstructions, lineInst);
       if (!lineDashInst) {
         std::cerr << "No match found in ICFG for instruction " << lineInst->getInstructionLabel() << "\n";
         std::cerr << "Skipping Instruction\n";
@@ -532,13 +682,13 @@ void getEdgesForAddedLines(Graph *MVICFG, Graph *ICFG, std::list<Graph_Line *> a
       } // End check for lineDashInst
       for (auto edgeDash : lineDashInst->getInstructionEdges()) {
         Graph_Instruction *fromDash = edgeDash->getEdgeFrom();
-        Graph_Instruction *from = getMatchedInstructionFromGraph(MVICFG, fromDash);
+        Graph_Instruction *from = getMatchedInstruction(mvicfgInstructions, fromDash);
         if (!from) {
           /* This edge would have been added by addToMVICFG */
           continue;
         } // End check for from
         Graph_Instruction *toDash = edgeDash->getEdgeTo();
-        Graph_Instruction *to = getMatchedInstructionFromGraph(MVICFG, toDash);
+        Graph_Instruction *to = getMatchedInstruction(mvicfgInstructions, toDash);
         if (!to) {
           /* This edge would have been added by addToMVICFG */
           continue;
@@ -553,8 +703,10 @@ void getEdgesForAddedLines(Graph *MVICFG, Graph *ICFG, std::list<Graph_Line *> a
   }       // End loop for line
 } // End getEdgesForAddedLines
 
-std::list<Graph_Line *> deleteFromMVICFG(Graph *MVICFG, Graph *ICFG, Diff_Mapping diff, unsigned Version) {
-  std::list<long long> deletedLines = diff.getDeletedLines();
+std::list<Graph_Line *> markDeletedInMVICFG(Graph *MVICFG, Graph *ICFG, Match_Context &context) {
+  const Diff_Mapping &diff = context.getDiff();
+  std::ostream &errors = context.getErrors();
+  const std::vector<long long> &deletedLines = diff.getDeletedLines();
   std::string fileName = diff.getFileName();
   std::list<Graph_Line *> N;
   /* Identify all deleted lines */
@@ -562,8 +714,8 @@ std::list<Graph_Line *> deleteFromMVICFG(Graph *MVICFG, Graph *ICFG, Diff_Mappin
     std::list<Graph_Line *> deletedGraphLines;
     deletedGraphLines = getGraphLinesGivenLine(MVICFG, line, fileName);
     if (deletedGraphLines.empty()) {
-      std::cerr << "Graph_Line for line " << line << " not found in MVICFG\n";
-      std::cerr << "Skipping this line and continuing\n";
+      errors << "Graph_Line for line " << line << " not found in MVICFG\n";
+      errors << "Skipping this line and continuing\n";
       continue;
     } // End check for deletedGraphLines
     for (auto deleteLine : deletedGraphLines) {
@@ -573,6 +725,13 @@ std::list<Graph_Line *> deleteFromMVICFG(Graph *MVICFG, Graph *ICFG, Diff_Mappin
       N.push_back(deleteLine);
     } // End loop for processing deletedGraphLines
   }   // End loop for identifying the deleted lines
+  return N;
+} // End markDeletedInMVICFG
+
+void addEdgesForDeletedNodes(Graph *MVICFG, Graph *ICFG, Match_Context &context, const std::list<Graph_Line *> &N,
+                             unsigned Version) {
+  std::ostream &errors = context.getErrors();
+  std::string fileName = context.getDiff().getFileName();
   for (auto func : MVICFG->getGraphFunctions()) {
     /* Proceed only if the function is in diff File being processed */
     if (func->getFunctionFile() == fileName) {
@@ -591,7 +750,7 @@ std::list<Graph_Line *> deleteFromMVICFG(Graph *MVICFG, Graph *ICFG, Diff_Mappin
               /* n has a successor or predecessor in N */
               /* Proceed only if the function is in diff File being processed */
               if (n->getGraphFunction()->getFunctionFile() == fileName) {
-                Graph_Line *nDash = findMatchedLine(n, ICFG, MVICFG, diff);
+                Graph_Line *nDash = findMatchedLine(n, ICFG, MVICFG, context);
                 if (!nDash) {
                   /* Check if 'n' exist in MVICFG currently, otherwise nDash won't exist obviously */
                   if (n->getLineNumber(MVICFG->getGraphVersion()) == 0) {
@@ -607,10 +766,10 @@ std::list<Graph_Line *> deleteFromMVICFG(Graph *MVICFG, Graph *ICFG, Diff_Mappin
                   for (auto mDash : MDash) {
                     /* Proceed only if the function is in diff File being processed */
                     if (mDash->getGraphFunction()->getFunctionFile() == fileName) {
-                      Graph_Line *m = findMatchedLine(mDash, MVICFG, ICFG, diff);
+                      Graph_Line *m = findMatchedLine(mDash, MVICFG, ICFG, context);
                       if (!m) {
                         /* Check if it was newly added ICFG line */
-                        m = getNewlyAdded(MVICFG, ICFG, mDash, diff);
+                        m = getNewlyAdded(MVICFG, ICFG, mDash, context.getDiff());
                       } // End check for m
                       if (m) {
                         auto findMPred = std::find_if(std::begin(predDash), std::end(predDash),
@@ -638,14 +797,14 @@ std::list<Graph_Line *> deleteFromMVICFG(Graph *MVICFG, Graph *ICFG, Diff_Mappin
                                 edgeType = checkBetweenEdge->getEdgeType();
                               } // End check for checkBetweenEdge
                               if (!foundEdge) {
-                                std::cerr << "ICFG edge between " << mInst->getInstructionLabel() << " and "
-                                          << nInst->getInstructionLabel() << " not found\n";
-                                std::cerr << "Setting edge type to MVICFG_DEL\n";
+                                errors << "ICFG edge between " << mInst->getInstructionLabel() << " and "
+                                       << nInst->getInstructionLabel() << " not found\n";
+                                errors << "Setting edge type to MVICFG_DEL\n";
                                 edgeType = Graph_Edge::MVICFG_DEL;
                               } // End check for foundEdge
                             }   // End check for getEdgeType
                             Graph_Edge *newEdge = new Graph_Edge(mInst, nInst, edgeType, Version);
-                            MVICFG->addEdge(mInst, nInst, newEdge);
+                            context.addEdge(mInst, nInst, newEdge);
                           } // End check for checkEdge
                         } else if (findMSucc != succDash.end()) {
                           /* Check for edge between n and m */
@@ -668,26 +827,26 @@ std::list<Graph_Line *> deleteFromMVICFG(Graph *MVICFG, Graph *ICFG, Diff_Mappin
                                 edgeType = checkBetweenEdge->getEdgeType();
                               } // End check for checkBetweenEdge
                               if (!foundEdge) {
-                                std::cerr << "ICFG edge between " << nInst->getInstructionLabel() << " and "
-                                          << mInst->getInstructionLabel() << " not found\n";
-                                std::cerr << "Setting edge type to MVICFG_DEL\n";
+                                errors << "ICFG edge between " << nInst->getInstructionLabel() << " and "
+                                       << mInst->getInstructionLabel() << " not found\n";
+                                errors << "Setting edge type to MVICFG_DEL\n";
                                 edgeType = Graph_Edge::MVICFG_DEL;
                               } // End check for foundEdge
                             }   // End check for getEdgeType
                             Graph_Edge *newEdge = new Graph_Edge(nInst, mInst, edgeType, Version);
-                            MVICFG->addEdge(nInst, mInst, newEdge);
+                            context.addEdge(nInst, mInst, newEdge);
                           } // End check for checkEdge
                         }   // End check for Predecessors and Successors
                       } else {
-                        std::cerr << "No matching line found for " << mDash->getLineNumber(ICFG->getGraphVersion())
-                                  << " in MVICFG(D)\n";
+                        errors << "No matching line found for " << mDash->getLineNumber(ICFG->getGraphVersion())
+                               << " in MVICFG(D)\n";
                       } // End check for m
                     }   // End check to see if the function is in the same diff file
                   }     // End loop for MDash
                 } else {
-                  std::cerr << "No matching line found for " << n->getLineNumber(MVICFG->getGraphVersion())
-                            << " in ICFG(" << ICFG->getGraphVersion() << ")\n";
-                  std::cerr << "file : " << fileName << "\n";
+                  errors << "No matching line found for " << n->getLineNumber(MVICFG->getGraphVersion())
+                         << " in ICFG(" << ICFG->getGraphVersion() << ")\n";
+                  errors << "file : " << fileName << "\n";
                 } // End check for nDash
               }   // End check to see if the function is in the same diff file
             }     // End check for T in N
@@ -696,12 +855,20 @@ std::list<Graph_Line *> deleteFromMVICFG(Graph *MVICFG, Graph *ICFG, Diff_Mappin
       }           // End loop for n
     }             // End check to see if the function is in the same diff file
   }               // End loop for adding edges for deleted lines
+} // End addEdgesForDeletedNodes
+
+std::list<Graph_Line *> deleteFromMVICFG(Graph *MVICFG, Graph *ICFG, Match_Context &context, unsigned Version) {
+  std::list<Graph_Line *> N = markDeletedInMVICFG(MVICFG, ICFG, context);
+  addEdgesForDeletedNodes(MVICFG, ICFG, context, N, Version);
   /* Return the deleted MVICFG lines */
   return N;
 } // End deleteFromMVICFG
 
-std::map<Graph_Line *, Graph_Line *> matchedInMVICFG(Graph *MVICFG, Graph *ICFG, Diff_Mapping diff, unsigned Version) {
-  std::map<long long, long long> matchedLines = diff.getMatchedLines();
+std::map<Graph_Line *, Graph_Line *> matchedInMVICFG(Graph *MVICFG, Graph *ICFG, Match_Context &context,
+                                                     unsigned Version) {
+  const Diff_Mapping &diff = context.getDiff();
+  std::ostream &errors = context.getErrors();
+  const std::vector<std::pair<long long, long long>> &matchedLines = diff.getMatchedLines();
   std::string fileName = diff.getFileName();
   std::map<Graph_Line *, Graph_Line *> matchedGraphLines;
   std::list<Graph_Line *> mvicfgM;
@@ -716,14 +883,14 @@ std::map<Graph_Line *, Graph_Line *> matchedInMVICFG(Graph *MVICFG, Graph *ICFG,
       std::list<Graph_Line *> icfgGraphLines;
       icfgGraphLines = getGraphLinesGivenLine(ICFG, icfgLineNo, fileName);
       if (icfgGraphLines.empty()) {
-        std::cerr << "Graph_Line for line " << icfgLineNo << " not found in ICFG\n";
-        std::cerr << "Skipping this line and continuing\n";
+        errors << "Graph_Line for line " << icfgLineNo << " not found in ICFG\n";
+        errors << "Skipping this line and continuing\n";
         continue;
       } // End check for if line is present in ICFG
       if (mvicfgGraphLines.size() != icfgGraphLines.size()) {
-        std::cerr << "Mismatch between the number of MVICFG and ICFG Graph_Lines for (" << line.first
-                  << "::" << line.second << ")\n";
-        std::cerr << "Skipping this line and continuing\n";
+        errors << "Mismatch between the number of MVICFG and ICFG Graph_Lines for (" << line.first
+               << "::" << line.second << ")\n";
+        errors << "Skipping this line and continuing\n";
         continue;
       } // End check for mismatch in GraphLine size
       for (auto mvicfgLine = mvicfgGraphLines.begin(), icfgLine = icfgGraphLines.begin();
@@ -747,7 +914,7 @@ std::map<Graph_Line *, Graph_Line *> matchedInMVICFG(Graph *MVICFG, Graph *ICFG,
         /* t in T and in Matched */
         /* Proceed only if the function is in diff File being processed */
         if (t->getGraphFunction()->getFunctionFile() == fileName) {
-          Graph_Line *tDash = findMatchedLine(t, MVICFG, ICFG, diff);
+          Graph_Line *tDash = findMatchedLine(t, MVICFG, ICFG, context);
           if (tDash) {
             auto findTPred = std::find_if(std::begin(pred), std::end(pred), [=](Graph_Line *N) { return (N == t); });
             auto findTSucc = std::find_if(std::begin(succ), std::end(succ), [=](Graph_Line *N) { return (N == t); });
@@ -763,9 +930,9 @@ std::map<Graph_Line *, Graph_Line *> matchedInMVICFG(Graph *MVICFG, Graph *ICFG,
                   foundEdge = true;
                   checkEdge = checkBetweenEdge;
                 } // End checkBetweenEdge
-                std::cerr << "MVICFG edge between " << tDashInst->getInstructionLabel() << " and "
-                          << nInst->getInstructionLabel() << " not found\n";
-                std::cerr << "Skipping this predecessor edge\n";
+                errors << "MVICFG edge between " << tDashInst->getInstructionLabel() << " and "
+                       << nInst->getInstructionLabel() << " not found\n";
+                errors << "Skipping this predecessor edge\n";
               } else {
                 foundEdge = true;
               } // End check for checkEdge
@@ -787,9 +954,9 @@ std::map<Graph_Line *, Graph_Line *> matchedInMVICFG(Graph *MVICFG, Graph *ICFG,
                   checkEdge = checkBetweenEdge;
                 } // End check for checkBetweenEdge
                 if (!foundEdge) {
-                  std::cerr << "MVICFG edge between " << tDashInst->getInstructionLabel() << " and "
-                            << nInst->getInstructionLabel() << " not found\n";
-                  std::cerr << "Skipping this successor edge\n";
+                  errors << "MVICFG edge between " << tDashInst->getInstructionLabel() << " and "
+                         << nInst->getInstructionLabel() << " not found\n";
+                  errors << "Skipping this successor edge\n";
                 } // End check for foundEdge
               } else {
                 foundEdge = true;
@@ -801,8 +968,7 @@ std::map<Graph_Line *, Graph_Line *> matchedInMVICFG(Graph *MVICFG, Graph *ICFG,
               }   // End check for foundEdge
             }     // End check for Successor
           } else {
-            std::cerr << "No matching line found for " << t->getLineNumber(ICFG->getGraphVersion())
-                      << " in MVICFG(M)\n";
+            errors << "No matching line found for " << t->getLineNumber(ICFG->getGraphVersion()) << " in MVICFG(M)\n";
           } // End check for tDash
         }   // End check to see if the function is in the same diff file
       }     // End check for find T
@@ -811,12 +977,13 @@ std::map<Graph_Line *, Graph_Line *> matchedInMVICFG(Graph *MVICFG, Graph *ICFG,
   return matchedGraphLines;
 } // End matchedInMVICFG
 
-void updateMVICFGVersion(Graph *MVICFG, std::list<Graph_Line *> addedLines, std::list<Graph_Line *> deletedLines,
-                         std::list<Diff_Mapping> diffMap, unsigned Version) {
+void updateMVICFGVersion(Graph *MVICFG, const std::list<Graph_Line *> &addedLines,
+                         const std::list<Graph_Line *> &deletedLines, const std::list<Diff_Mapping> &diffMap,
+                         unsigned Version) {
   /* Update Graph_Line information */
   for (auto func : MVICFG->getGraphFunctions()) {
     auto findDiff = std::find_if(std::begin(diffMap), std::end(diffMap),
-                                 [=](Diff_Mapping d) { return (d.getFileName() == func->getFunctionFile()); });
+                                 [=](const Diff_Mapping &d) { return (d.getFileName() == func->getFunctionFile()); });
     if (findDiff != diffMap.end()) {
       for (auto line : func->getFunctionLines()) {
         auto findInAdd = std::find_if(std::begin(addedLines), std::end(addedLines),
@@ -887,4 +1054,63 @@ void updateMVICFGVersion(Graph *MVICFG, std::list<Graph_Line *> addedLines, std:
     }       // End check for edgeFromInst
   }         // End loop for updating Graph_Edge information
 } // End updateMVICFGVersion
+
+void mergeICFG(Graph *MVICFG, Graph *ICFG, const std::list<Diff_Mapping> &diffMap, unsigned Version) {
+  mergeICFG(MVICFG, ICFG, diffMap, Version, 1);
+} // End mergeICFG
+
+void mergeICFG(Graph *MVICFG, Graph *ICFG, const std::list<Diff_Mapping> &diffMap, unsigned Version,
+               unsigned threadCount) {
+  std::list<Graph_Line *> addedLines;
+  std::list<Graph_Line *> deletedLines;
+  if (threadCount <= 1 || diffMap.size() <= 1) {
+    for (auto &diff : diffMap) {
+      Match_Context context(diff);
+      std::list<Graph_Line *> diffAddedLines = addToMVICFG(MVICFG, ICFG, context, Version);
+      addedLines.splice(addedLines.end(), diffAddedLines);
+      std::list<Graph_Line *> diffDeletedLines = deleteFromMVICFG(MVICFG, ICFG, context, Version);
+      deletedLines.splice(deletedLines.end(), diffDeletedLines);
+      matchedInMVICFG(MVICFG, ICFG, context, Version);
+      context.flushEdges(MVICFG);
+    } // End loop for diffMap
+  } else {
+    std::vector<const Diff_Mapping *> diffs;
+    for (auto &diff : diffMap) {
+      diffs.push_back(&diff);
+    } // End loop for diffMap
+    /* Contexts and streams are held by value. A deque never moves them, as contexts point at their stream */
+    std::deque<std::ostringstream> diffErrors(diffs.size());
+    std::deque<Match_Context> contexts;
+    std::vector<std::list<Graph_Line *>> diffAddedLines(diffs.size());
+    std::vector<std::list<Graph_Line *>> diffIcfgLines(diffs.size());
+    std::vector<std::list<Graph_Line *>> diffDeletedLines(diffs.size());
+    /* Nodes first, so that IDs, functions and the line index of MVICFG only change on this thread */
+    for (std::size_t index = 0; index < diffs.size(); ++index) {
+      contexts.emplace_back(*diffs[index], diffErrors[index]);
+      diffAddedLines[index] = addNodesToMVICFG(MVICFG, ICFG, contexts[index], Version, diffIcfgLines[index]);
+      diffDeletedLines[index] = markDeletedInMVICFG(MVICFG, ICFG, contexts[index]);
+    } // End loop for nodes
+    /*
+     * Each worker owns the functions of one file. It only calls pushEdgeVersions and pushEdgeInstruction on
+     * instructions of that file, and new edges wait in its context. Edges that cross files are left to
+     * getEdgesForAddedLines. Breaking this lets two workers write the edge list of the same instruction
+     */
+    parallelFor(diffs.size(), threadCount, [&](std::size_t index) {
+      Match_Context &context = contexts[index];
+      addEdgesForAddedNodes(MVICFG, ICFG, context, diffAddedLines[index], diffIcfgLines[index], Version);
+      addEdgesForDeletedNodes(MVICFG, ICFG, context, diffDeletedLines[index], Version);
+      matchedInMVICFG(MVICFG, ICFG, context, Version);
+    });
+    for (std::size_t index = 0; index < diffs.size(); ++index) {
+      std::cerr << diffErrors[index].str();
+      contexts[index].flushEdges(MVICFG);
+      addedLines.splice(addedLines.end(), diffAddedLines[index]);
+      deletedLines.splice(deletedLines.end(), diffDeletedLines[index]);
+    } // End loop for files
+  }   // End check for threadCount
+  /* Edges across files, such as calls to and from added lines, are only added here */
+  getEdgesForAddedLines(MVICFG, ICFG, addedLines);
+  updateMVICFGVersion(MVICFG, addedLines, deletedLines, diffMap, Version);
+  MVICFG->setGraphVersion(Version);
+} // End mergeICFG
 } // namespace hydrogen_framework
@@ -11,16 +11,22 @@
 #include <boost/filesystem.hpp>
 #include <list>
 #include <llvm/IR/Instruction.h>
+#include <llvm/IR/ModuleSlotTracker.h>
 #include <map>
+#include <ostream>
 #include <set>
 #include <string>
+#include <unordered_map>
 namespace hydrogen_framework {
 /* Forward declaration */
+class Diff_Fingerprint;
 class Diff_Mapping;
+class Diff_Patch;
 class Graph;
 class Graph_Edge;
 class Graph_Instruction;
 class Graph_Line;
+class Match_Context;
 class Module;
 
 /**
@@ -28,11 +34,50 @@ class Module;
  */
 Graph *buildICFG(Module *mod, unsigned graphVersion);
 
+/**
+ * Build ICFG for the given module into an empty, already configured Graph
+ * When the Graph has more than one thread, function subgraphs are built on workers and merged in module order,
+ * giving the same node IDs as a serial build
+ */
+Graph *buildICFG(Module *mod, Graph *ICFG);
+
+/**
+ * Build the Graph_Function for a single LLVM Function and push it into the given Graph
+ * Adds sequential and virtual edges only. Branch and call edges are added once all functions are built
+ */
+void buildFunctionICFG(Graph *ICFG, llvm::Function &F);
+
+/**
+ * Build the Graph_Function for a single LLVM Function, printing labels through moduleSlots, a tracker of its module
+ * Safe to call from worker threads as long as every thread has its own moduleSlots
+ */
+void buildFunctionICFG(Graph *ICFG, llvm::Function &F, llvm::ModuleSlotTracker &moduleSlots);
+
 /**
  * Generate Line Mappings between two modules
  */
 std::list<Diff_Mapping> generateLineMapping(Module *firstMod, Module *secondMod);
 
+/**
+ * Generate Line Mappings between two modules, diffing file pairs on up to threadCount workers
+ * Files are paired by file name. Mappings follow the files of firstMod, then the new files of secondMod
+ */
+std::list<Diff_Mapping> generateLineMapping(Module *firstMod, Module *secondMod, unsigned threadCount);
+
+/**
+ * Generate Line Mappings between two modules, matching their IR through the fingerprints of both modules
+ * Only the lines around blocks whose fingerprint changed are diffed as text. Falls back to the text diff of whole
+ * files if either fingerprint is NULL
+ */
+std::list<Diff_Mapping> generateLineMapping(Module *firstMod, Module *secondMod, unsigned threadCount,
+                                            const Diff_Fingerprint *firstPrint, const Diff_Fingerprint *secondPrint);
+
+/**
+ * Generate Line Mappings from a precomputed unified diff against the files of the previous version ICFG
+ * No source file is read. Files of ICFG missing from patch are unchanged, files of patch are mapped from its hunks
+ */
+std::list<Diff_Mapping> generateLineMapping(Graph *ICFG, const Diff_Patch &patch);
+
 /**
  * Get Graph_Line(s) from given source line
  * Returns empty list if no Graph_Line is not found
@@ -58,18 +103,18 @@ std::string getGraphLineInstructionsAsString(Graph_Line *line);
 /**
  * Heuristically try to find the closest Graph_Line match from a list of potential Graph_Line matches
  * when no exact match is found using getGraphLineInstructionsAsString
- * Currently will throw an warning if heuristic skips more than 2 OpCode to match the lines
+ * Currently will write a warning to errors if heuristic skips more than 2 OpCode to match the lines
  * Returns NULL if no heuristic match is found
  */
 Graph_Line *resolveMatchedLinesWithNoExtactStringMatch(std::list<Graph_Line *> matchedLines, std::string lineFromString,
-                                                       unsigned int graphVersion);
+                                                       unsigned int graphVersion, std::ostream &errors);
 
 /**
- * Find matched Node
+ * Find matched Node using the diff of context
  * Returns NULL if no match found
  * Always make sure to check that the Graph_Line is from the diff being used
  */
-Graph_Line *findMatchedLine(Graph_Line *t, Graph *matchTo, Graph *matchFrom, Diff_Mapping diff);
+Graph_Line *findMatchedLine(Graph_Line *t, Graph *matchTo, Graph *matchFrom, Match_Context &context);
 
 /**
  * Get the edge between two given nodes
@@ -90,12 +135,26 @@ Graph_Edge *getInBetweenEdge(Graph_Line *fromLine, Graph_Line *toLine);
  * Used only when findMatchedLine fails to retrieve the same
  * Returns NULL if no such line is found
  */
-Graph_Line *getNewlyAdded(Graph *MVICFG, Graph *ICFG, Graph_Line *newLine, Diff_Mapping diff);
+Graph_Line *getNewlyAdded(Graph *MVICFG, Graph *ICFG, Graph_Line *newLine, const Diff_Mapping &diff);
 
 /**
- * Add nodes to MVICFG and returns the added MVICFG lines
+ * Add the nodes of the added lines of the diff of context to MVICFG and returns the added MVICFG lines
+ * The ICFG line each of them was copied from is appended to icfgN
  */
-std::list<Graph_Line *> addToMVICFG(Graph *MVICFG, Graph *ICFG, Diff_Mapping diff, unsigned Version);
+std::list<Graph_Line *> addNodesToMVICFG(Graph *MVICFG, Graph *ICFG, Match_Context &context, unsigned Version,
+                                         std::list<Graph_Line *> &icfgN);
+
+/**
+ * Add the edges between the added MVICFG lines N and the rest of the diff file through context
+ * Reads MVICFG but only changes the edges of lines in the diff file
+ */
+void addEdgesForAddedNodes(Graph *MVICFG, Graph *ICFG, Match_Context &context, const std::list<Graph_Line *> &N,
+                           const std::list<Graph_Line *> &icfgN, unsigned Version);
+
+/**
+ * Add nodes to MVICFG for the diff of context and returns the added MVICFG lines
+ */
+std::list<Graph_Line *> addToMVICFG(Graph *MVICFG, Graph *ICFG, Match_Context &context, unsigned Version);
 
 /**
  * Get matching Graph_Instruction from given Graph given a Graph_Instruction using LLVM PTR
@@ -103,26 +162,60 @@ std::list<Graph_Line *> addToMVICFG(Graph *MVICFG, Graph *ICFG, Diff_Mapping dif
  */
 Graph_Instruction *getMatchedInstructionFromGraph(Graph *graphToMatch, Graph_Instruction *instToMatch);
 
+/**
+ * Index the Graph_Instructions of graph by LLVM PTR, keeping the first one in graph order
+ * Lookups give the same match as getMatchedInstructionFromGraph for instructions with a PTR
+ */
+std::unordered_map<llvm::Instruction *, Graph_Instruction *> getInstructionIndex(Graph *graph);
+
 /**
  * Import edges from ICFG instruction for added Graph_Line
  */
-void getEdgesForAddedLines(Graph *MVICFG, Graph *ICFG, std::list<Graph_Line *> addedLines,
-                           std::list<Diff_Mapping> diffMap, unsigned Version);
+void getEdgesForAddedLines(Graph *MVICFG, Graph *ICFG, const std::list<Graph_Line *> &addedLines);
+
+/**
+ * Mark the lines deleted by the diff of context in MVICFG and returns them
+ */
+std::list<Graph_Line *> markDeletedInMVICFG(Graph *MVICFG, Graph *ICFG, Match_Context &context);
 
 /**
- * Mark deleted nodes in MVICFG and returns the deleted MVICFG lines
+ * Add the edges around the deleted MVICFG lines N within the diff file through context
+ * Reads MVICFG but only changes the edges of lines in the diff file
  */
-std::list<Graph_Line *> deleteFromMVICFG(Graph *MVICFG, Graph *ICFG, Diff_Mapping diff, unsigned Version);
+void addEdgesForDeletedNodes(Graph *MVICFG, Graph *ICFG, Match_Context &context, const std::list<Graph_Line *> &N,
+                             unsigned Version);
 
 /**
- * Returns the corresponding matched Graph_Line in MVICFG from ICFG
+ * Mark deleted nodes in MVICFG for the diff of context and returns the deleted MVICFG lines
  */
-std::map<Graph_Line *, Graph_Line *> matchedInMVICFG(Graph *MVICFG, Graph *ICFG, Diff_Mapping diff, unsigned Version);
+std::list<Graph_Line *> deleteFromMVICFG(Graph *MVICFG, Graph *ICFG, Match_Context &context, unsigned Version);
+
+/**
+ * Returns the corresponding matched Graph_Line in MVICFG from ICFG for the diff of context
+ */
+std::map<Graph_Line *, Graph_Line *> matchedInMVICFG(Graph *MVICFG, Graph *ICFG, Match_Context &context,
+                                                     unsigned Version);
 
 /**
  * Update the Edge and Node information for MVICFG
  */
-void updateMVICFGVersion(Graph *MVICFG, std::list<Graph_Line *> addedLines, std::list<Graph_Line *> deletedLines,
-                         std::list<Diff_Mapping> diffMap, unsigned Version);
+void updateMVICFGVersion(Graph *MVICFG, const std::list<Graph_Line *> &addedLines,
+                         const std::list<Graph_Line *> &deletedLines, const std::list<Diff_Mapping> &diffMap,
+                         unsigned Version);
+
+/**
+ * Merge the ICFG of Version into MVICFG with the line mappings from the current MVICFG version, and move MVICFG
+ * on to Version. MVICFG only keeps the LLVM instructions of ICFG, so ICFG can be released afterwards
+ */
+void mergeICFG(Graph *MVICFG, Graph *ICFG, const std::list<Diff_Mapping> &diffMap, unsigned Version);
+
+/**
+ * Merge the ICFG of Version into MVICFG, with the files of diffMap merged on up to threadCount workers
+ * Nodes are added and marked deleted for every file first, in diffMap order. Each worker then adds the edges of
+ * one file, which only touch the functions of that file. Edges across files, such as calls, are added serially
+ * afterwards. Messages of each file are written once all workers are done, in diffMap order
+ */
+void mergeICFG(Graph *MVICFG, Graph *ICFG, const std::list<Diff_Mapping> &diffMap, unsigned Version,
+               unsigned threadCount);
 } // namespace hydrogen_framework
 #endif
@@ -0,0 +1,37 @@
+/**
+ * @file
+ * Implementing Match_Context.hpp
+ */
+#include "Match_Context.hpp"
+#include "Graph.hpp"
+#include "Graph_Edge.hpp"
+#include "Graph_Instruction.hpp"
+#include "Graph_Line.hpp"
+namespace hydrogen_framework {
+const std::vector<unsigned> &Match_Context::getLineOpcodes(Graph_Line *line) {
+  auto findLine = lineOpcodes.find(line);
+  if (findLine != lineOpcodes.end()) {
+    return findLine->second;
+  } // End check for cached line
+  std::vector<unsigned> &opcodes = lineOpcodes[line];
+  for (auto inst : line->getLineInstructions()) {
+    for (auto I : inst->getInstructionRange()) {
+      opcodes.push_back(I->getOpcode());
+    } // End loop for Instruction range
+  }   // End loop for Graph_Line
+  return opcodes;
+} // End getLineOpcodes
+
+void Match_Context::addEdge(Graph_Instruction *from, Graph_Instruction *to, Graph_Edge *edge) {
+  from->pushEdgeInstruction(edge);
+  to->pushEdgeInstruction(edge);
+  addedEdges.push_back(edge);
+} // End addEdge
+
+void Match_Context::flushEdges(Graph *graph) {
+  for (auto edge : addedEdges) {
+    graph->pushGraphEdges(edge);
+  } // End loop for addedEdges
+  addedEdges.clear();
+} // End flushEdges
+} // namespace hydrogen_framework
@@ -0,0 +1,73 @@
+/**
+ * @file
+ * Match_Context Class: State shared by the line matching steps of one diff file during an MVICFG merge
+ */
+#ifndef MATCH_CONTEXT_H
+#define MATCH_CONTEXT_H
+
+#include <iostream>
+#include <list>
+#include <unordered_map>
+#include <vector>
+namespace hydrogen_framework {
+/* Forward declaration */
+class Diff_Mapping;
+class Graph;
+class Graph_Edge;
+class Graph_Instruction;
+class Graph_Line;
+
+/**
+ * Match_Context Class: Holds the Diff_Mapping of a file by reference and the opcodes of the Graph_Lines matched so far
+ * Lines are compared through their opcodes many times while edges are added, so they are gathered once per line.
+ * Edges and messages of the merge steps go through the context, so that files can be merged on separate workers
+ */
+class Match_Context {
+public:
+  /**
+   * Constructor
+   * The Diff_Mapping must outlive the context
+   */
+  Match_Context(const Diff_Mapping &mapping) : diff(mapping), errors(&std::cerr) {}
+
+  /**
+   * Constructor
+   * Messages are written to errorStream instead of std::cerr
+   */
+  Match_Context(const Diff_Mapping &mapping, std::ostream &errorStream) : diff(mapping), errors(&errorStream) {}
+
+  /**
+   * Return diff
+   */
+  const Diff_Mapping &getDiff() const { return diff; }
+
+  /**
+   * Return the opcodes of the instructions in line, in the order of getGraphLineInstructionsAsString
+   * Gathered on first request. The instructions of line must not change afterwards
+   */
+  const std::vector<unsigned> &getLineOpcodes(Graph_Line *line);
+
+  /**
+   * Return the stream for messages of the merge steps
+   */
+  std::ostream &getErrors() { return *errors; }
+
+  /**
+   * Link edge to from and to, and hold it back from the Graph until flushEdges
+   * Only the instructions at both ends are touched
+   */
+  void addEdge(Graph_Instruction *from, Graph_Instruction *to, Graph_Edge *edge);
+
+  /**
+   * Push the edges held back by addEdge into graph, in the order they were added
+   */
+  void flushEdges(Graph *graph);
+
+private:
+  const Diff_Mapping &diff;                                            /**< Line mapping of the file being merged */
+  std::ostream *errors;                                                /**< Stream for messages */
+  std::unordered_map<Graph_Line *, std::vector<unsigned>> lineOpcodes; /**< Opcodes of each line seen so far */
+  std::list<Graph_Edge *> addedEdges;                                  /**< Edges not yet pushed into the Graph */
+};                                                                     // End Match_Context Class
+} // namespace hydrogen_framework
+#endif
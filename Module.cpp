@@ -4,25 +4,113 @@
  * Implementing Module.hpp
  */
 #include "Module.hpp"
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/GlobalAlias.h>
+#include <llvm/Support/Error.h>
 namespace hydrogen_framework {
-bool Module::setModule(int ver, std::string file) {
+bool Module::setModule(int ver, std::string file, llvm::raw_ostream &errors) {
   modVersion = ver;
+  modFile = file;
   llvm::StringRef modulePath(file);
   llvm::SMDiagnostic error;
-  modPtr = llvm::parseIRFile(modulePath, error, modContext);
+  if (modLazy) {
+    /* Bitcode function bodies stay unparsed until materializeFunction */
+    modPtr = llvm::getLazyIRFileModule(modulePath, error, modContext);
+  } else {
+    modPtr = llvm::parseIRFile(modulePath, error, modContext);
+  } // End check for modLazy
   /* Parsing Error handling */
   if (!modPtr) {
     std::string errorMessage;
     llvm::raw_string_ostream output(errorMessage);
     /* error.print("Error in parsing the file ", output); */
-    std::cerr << "Error in parsing the " << file << "\n";
+    errors << "Error in parsing the " << file << "\n";
     return false;
   } // End check for modPtr
-  /* Verifying Module */
-  if (llvm::verifyModule(*modPtr, &llvm::errs()) != 0) {
-    std::cerr << "Error in verifying the Module : " << file << "\n";
+  /* Verifying Module. Bodies that are not materialized yet are verified by materializeFunction */
+  if (!modTrusted && llvm::verifyModule(*modPtr, &errors) != 0) {
+    errors << "Error in verifying the Module : " << file << "\n";
     return false;
   } // End check for verifyModule
   return true;
 } // End setModule
+
+bool Module::materializeFunction(llvm::Function &F, llvm::raw_ostream &errors) {
+  if (!F.isMaterializable()) {
+    return true;
+  } // End check for isMaterializable
+  if (llvm::Error error = F.materialize()) {
+    errors << "Error in loading the function " << F.getName().str() << " : " << llvm::toString(std::move(error))
+           << "\n";
+    return false;
+  } // End check for materialize
+  if (!modTrusted && llvm::verifyFunction(F, &errors)) {
+    errors << "Error in verifying the function : " << F.getName().str() << "\n";
+    return false;
+  } // End check for verifyFunction
+  return true;
+} // End materializeFunction
+
+/**
+ * Collect the functions referenced by V, looking through constant expressions, aggregates and aliases
+ */
+static void collectReferencedFunctions(llvm::Value *V, std::set<llvm::Value *> &visited,
+                                       std::set<llvm::Function *> &reached, std::list<llvm::Function *> &worklist) {
+  if (!llvm::isa<llvm::Constant>(V) || !visited.insert(V).second) {
+    return;
+  } // End check for unvisited constant
+  if (llvm::Function *F = llvm::dyn_cast<llvm::Function>(V)) {
+    if (reached.insert(F).second) {
+      worklist.push_back(F);
+    } // End check for new function
+    return;
+  } // End check for Function
+  if (llvm::GlobalAlias *alias = llvm::dyn_cast<llvm::GlobalAlias>(V)) {
+    collectReferencedFunctions(alias->getAliasee(), visited, reached, worklist);
+    return;
+  } // End check for GlobalAlias
+  if (llvm::isa<llvm::GlobalValue>(V)) {
+    /* Initializers of globals are collected once up front */
+    return;
+  } // End check for GlobalValue
+  for (llvm::Value *operand : llvm::cast<llvm::Constant>(V)->operands()) {
+    collectReferencedFunctions(operand, visited, reached, worklist);
+  } // End loop for operands
+} // End collectReferencedFunctions
+
+bool Module::restrictToReachable(std::string root, llvm::raw_ostream &errors) {
+  llvm::Function *rootFunc = modPtr->getFunction(root);
+  if (!rootFunc || rootFunc->isDeclaration()) {
+    errors << "Function " << root << " not found in " << modFile << ". Keeping every function\n";
+    return false;
+  } // End check for rootFunc
+  std::set<llvm::Value *> visited;
+  std::set<llvm::Function *> reached;
+  std::list<llvm::Function *> worklist;
+  reached.insert(rootFunc);
+  worklist.push_back(rootFunc);
+  /* Functions stored in globals can be called through pointers from any reached function */
+  for (llvm::GlobalVariable &G : modPtr->globals()) {
+    if (G.hasInitializer()) {
+      collectReferencedFunctions(G.getInitializer(), visited, reached, worklist);
+    } // End check for hasInitializer
+  }   // End loop for globals
+  while (!worklist.empty()) {
+    llvm::Function *F = worklist.front();
+    worklist.pop_front();
+    if (!materializeFunction(*F, errors)) {
+      return false;
+    } // End check for materializeFunction
+    for (llvm::BasicBlock &BB : *F) {
+      for (llvm::Instruction &I : BB) {
+        for (llvm::Value *operand : I.operands()) {
+          collectReferencedFunctions(operand, visited, reached, worklist);
+        } // End loop for operands
+      }   // End loop for BasicBlock
+    }     // End loop for Function
+  }       // End loop for worklist
+  modReachable.swap(reached);
+  modReachableOnly = true;
+  return true;
+} // End restrictToReachable
 } // namespace hydrogen_framework
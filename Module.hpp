@@ -8,12 +8,14 @@
 
 #include <iostream>
 #include <list>
+#include <llvm/IR/Function.h>
 #include <llvm/IR/LLVMContext.h>
 #include <llvm/IR/Module.h>
 #include <llvm/IR/Verifier.h>
 #include <llvm/IRReader/IRReader.h>
 #include <llvm/Support/SourceMgr.h>
 #include <llvm/Support/raw_ostream.h>
+#include <set>
 
 namespace hydrogen_framework {
 /**
@@ -25,7 +27,7 @@ public:
    * Constructor for module class
    * Set version to zero
    */
-  Module() { modVersion = 0; }
+  Module() : modVersion(0), modLazy(false), modTrusted(false), modReachableOnly(false) {}
 
   /**
    * Destructor
@@ -36,7 +38,65 @@ public:
    * Set module by initializing all the values except modFiles
    * Returns FALSE if LLVM IR parsing error is found
    */
-  bool setModule(int ver, std::string file);
+  bool setModule(int ver, std::string file) { return setModule(ver, file, llvm::errs()); }
+
+  /**
+   * Set module by initializing all the values except modFiles, writing parse and verifier errors to errors
+   * Modules loaded on different threads need their own errors stream
+   */
+  bool setModule(int ver, std::string file, llvm::raw_ostream &errors);
+
+  /**
+   * Load the function bodies of bitcode only when materializeFunction asks for them
+   * Call before setModule. Textual IR is always parsed in full
+   */
+  void setLazyLoading(bool lazy) { modLazy = lazy; }
+
+  /**
+   * Return modLazy
+   */
+  bool isLazyLoading() { return modLazy; }
+
+  /**
+   * Skip the verification of the module and of materialized functions
+   * Call before setModule. Only for inputs known to be well formed
+   */
+  void setTrustedInput(bool trusted) { modTrusted = trusted; }
+
+  /**
+   * Restrict the module to the functions reachable from the function root through direct calls and function
+   * addresses. Only the reached functions are materialized
+   * Returns FALSE and keeps every function if root is not defined or a body fails to load
+   */
+  bool restrictToReachable(std::string root) { return restrictToReachable(root, llvm::errs()); }
+
+  /**
+   * Restrict the module to the functions reachable from the function root, writing errors to errors
+   */
+  bool restrictToReachable(std::string root, llvm::raw_ostream &errors);
+
+  /**
+   * Return modReachableOnly
+   */
+  bool isReachableOnly() { return modReachableOnly; }
+
+  /**
+   * Return true if F is left out by restrictToReachable
+   */
+  bool isFunctionSkipped(llvm::Function &F) {
+    return modReachableOnly && modReachable.find(&F) == modReachable.end();
+  }
+
+  /**
+   * Parse and verify the body of F if it has not been loaded yet. Verification is skipped for trusted input
+   * Returns FALSE if the body cannot be loaded or is broken. Not thread safe
+   */
+  bool materializeFunction(llvm::Function &F) { return materializeFunction(F, llvm::errs()); }
+
+  /**
+   * Parse and verify the body of F if it has not been loaded yet, writing errors to errors
+   */
+  bool materializeFunction(llvm::Function &F, llvm::raw_ostream &errors);
 
   /**
    * Set modFiles by swapping out with the incoming list of files
@@ -58,11 +118,21 @@ public:
    */
   std::list<std::string> getFiles() { return modFiles; }
 
+  /**
+   * Return modFile
+   */
+  std::string getModuleFile() { return modFile; }
+
 private:
-  int modVersion;                       /**< Module Version */
-  llvm::LLVMContext modContext;         /**< LLVM Module Context */
-  std::unique_ptr<llvm::Module> modPtr; /**< LLVM Module Pointer */
-  std::list<std::string> modFiles;      /**< Source files for the LLVM Module */
-};                                      // End module class
+  int modVersion;                          /**< Module Version */
+  std::string modFile;                     /**< Path of the LLVM IR file */
+  bool modLazy;                            /**< Function bodies are loaded on demand */
+  bool modTrusted;                         /**< Verification is skipped */
+  bool modReachableOnly;                   /**< Only functions in modReachable are used */
+  std::set<llvm::Function *> modReachable; /**< Functions reachable from the root of restrictToReachable */
+  llvm::LLVMContext modContext;            /**< LLVM Module Context */
+  std::unique_ptr<llvm::Module> modPtr;    /**< LLVM Module Pointer */
+  std::list<std::string> modFiles;         /**< Source files for the LLVM Module */
+};                                         // End module class
 } // namespace hydrogen_framework
 #endif
@@ -0,0 +1,42 @@
+/**
+ * @file
+ * Implementing Parallel_Util.hpp
+ */
+#include "Parallel_Util.hpp"
+#include <atomic>
+#include <thread>
+#include <vector>
+namespace hydrogen_framework {
+unsigned getDefaultThreadCount() {
+  unsigned hardwareThreads = std::thread::hardware_concurrency();
+  if (hardwareThreads == 0) {
+    return 1;
+  } // End check for hardwareThreads
+  return hardwareThreads;
+} // End getDefaultThreadCount
+
+void parallelFor(std::size_t count, unsigned threadCount, std::function<void(std::size_t)> task) {
+  if (threadCount <= 1 || count <= 1) {
+    for (std::size_t index = 0; index < count; ++index) {
+      task(index);
+    } // End loop for index
+    return;
+  } // End check for serial execution
+  if (threadCount > count) {
+    threadCount = static_cast<unsigned>(count);
+  } // End check for idle workers
+  std::atomic<std::size_t> nextIndex(0);
+  std::vector<std::thread> workers;
+  workers.reserve(threadCount);
+  for (unsigned worker = 0; worker < threadCount; ++worker) {
+    workers.push_back(std::thread([&]() {
+      for (std::size_t index = nextIndex++; index < count; index = nextIndex++) {
+        task(index);
+      } // End loop for index
+    }));
+  } // End loop for spawning workers
+  for (auto &worker : workers) {
+    worker.join();
+  } // End loop for joining workers
+} // End parallelFor
+} // namespace hydrogen_framework
@@ -0,0 +1,24 @@
+/**
+ * @file
+ * Parallel Util: Minimal worker pool helpers shared by the parallel build, diff and export modes
+ */
+#ifndef PARALLEL_UTIL_H
+#define PARALLEL_UTIL_H
+
+#include <cstddef>
+#include <functional>
+namespace hydrogen_framework {
+/**
+ * Return the number of worker threads to use when the user asks for parallelism without a count
+ * Never returns less than 1
+ */
+unsigned getDefaultThreadCount();
+
+/**
+ * Run task(index) for every index in [0, count) using up to threadCount worker threads
+ * Indices are handed out one at a time so uneven tasks still balance across workers
+ * Runs inline on the calling thread when threadCount or count is at most 1
+ */
+void parallelFor(std::size_t count, unsigned threadCount, std::function<void(std::size_t)> task);
+} // namespace hydrogen_framework
+#endif
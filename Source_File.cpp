@@ -0,0 +1,57 @@
+/**
+ * @file
+ * Implementing Source_File.hpp
+ */
+#include "Source_File.hpp"
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+namespace hydrogen_framework {
+bool Source_File::openFile(std::string path) {
+  closeFile();
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd == -1) {
+    return false;
+  } // End check for open
+  struct stat buffer;
+  if (fstat(fd, &buffer) == -1) {
+    close(fd);
+    return false;
+  } // End check for fstat
+  if (buffer.st_size == 0) {
+    /* Empty file has no lines and nothing to map */
+    close(fd);
+    return true;
+  } // End check for empty file
+  void *data = mmap(NULL, buffer.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    return false;
+  } // End check for mmap
+  fileData = static_cast<const char *>(data);
+  fileSize = buffer.st_size;
+  /* Split on newlines only. A last line without a newline is still a line, like getline */
+  const char *current = fileData;
+  const char *end = fileData + fileSize;
+  while (current < end) {
+    const char *newline = static_cast<const char *>(std::memchr(current, '\n', end - current));
+    if (!newline) {
+      newline = end;
+    } // End check for last line
+    fileLines.push_back(Diff_Line(current, newline - current));
+    current = newline + 1;
+  } // End loop for lines
+  return true;
+} // End openFile
+
+void Source_File::closeFile() {
+  if (fileData) {
+    munmap(const_cast<char *>(fileData), fileSize);
+  } // End check for fileData
+  fileData = NULL;
+  fileSize = 0;
+  fileLines.clear();
+} // End closeFile
+} // namespace hydrogen_framework
@@ -0,0 +1,61 @@
+/**
+ * @file
+ * Source_File Class: Memory mapped source file split into line views
+ */
+#ifndef SOURCE_FILE_H
+#define SOURCE_FILE_H
+
+#include "Diff_Util.hpp"
+#include <cstddef>
+#include <string>
+#include <vector>
+namespace hydrogen_framework {
+/**
+ * Source_File Class: Maps a source file read-only and splits it into lines the way getline does
+ * Lines point into the mapping and stay valid until the Source_File is closed or destroyed
+ */
+class Source_File {
+public:
+  /**
+   * Constructor
+   */
+  Source_File() : fileData(NULL), fileSize(0) {}
+
+  /**
+   * Destructor
+   */
+  ~Source_File() { closeFile(); }
+
+  /**
+   * Source_File owns its mapping and cannot be copied
+   */
+  Source_File(const Source_File &) = delete;
+
+  /**
+   * Source_File owns its mapping and cannot be assigned
+   */
+  Source_File &operator=(const Source_File &) = delete;
+
+  /**
+   * Map the file at path and split it into lines
+   * Returns FALSE if the file cannot be opened. The Source_File is then empty
+   */
+  bool openFile(std::string path);
+
+  /**
+   * Unmap the file and drop its lines
+   */
+  void closeFile();
+
+  /**
+   * Return the lines of the file, without their newline
+   */
+  const std::vector<Diff_Line> &getLines() const { return fileLines; }
+
+private:
+  const char *fileData;             /**< Start of the mapped file. NULL if none is mapped */
+  std::size_t fileSize;             /**< Size of the mapped file */
+  std::vector<Diff_Line> fileLines; /**< Lines of the file */
+};                                  // End Source_File Class
+} // namespace hydrogen_framework
+#endif
@@ -0,0 +1,17 @@
+#include <stdio.h>
+int main() {
+  int x;
+  int y;
+  int z;
+
+  // x is set by scanf before it is used.
+  scanf("%d", &x);
+  printf("%d", x);
+
+  // scanf may read y, so this store is not dead.
+  y = 2; scanf("%d", &y);
+
+  z = 1; // z is set and not used, since the store below overwrites it first.
+  z = 2; scanf("%d", &z);
+  return 0;
+}
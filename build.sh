@@ -2,10 +2,16 @@ function clang-llvm() {
 	clang -c -O0 -Xclang -disable-O0-optnone -g -fno-discard-value-names -emit-llvm -S $1.c -o $1.bc
 }
 
-# meant to be run from within the ninja directory
+# meant to be run from within the ninja directory, further arguments are passed on to Hydrogen
 function run() {
 	echo "Running Liveness Analysis on test case $1"
-	./Hydrogen.out ../TestPrograms/$1.bc :: ../TestPrograms/$1.c
+	./Hydrogen.out ../TestPrograms/$1.bc :: ../TestPrograms/$1.c "${@:2}"
+}
+
+# builds the MVICFG of two versions, meant to be run from within the ninja directory
+function run-versions() {
+	echo "Running Liveness Analysis on versions $1 and $2"
+	./Hydrogen.out ../TestPrograms/$1.bc ../TestPrograms/$2.bc :: ../TestPrograms/$1.c :: ../TestPrograms/$2.c
 }
 
 
@@ -16,6 +22,7 @@ clang-llvm changed_var
 clang-llvm unchanged_var
 clang-llvm used_func
 clang-llvm dead_func
+clang-llvm escaped_var
 cd ..
 
 
@@ -31,5 +38,7 @@ run changed_var
 run unchanged_var
 run used_func
 run dead_func
+run escaped_var --ifds
+run-versions unchanged_var changed_var
 cd ..
 chmod -R 777 ninja